@@ -10,13 +10,33 @@ CONFIG += c++17
 
 SOURCES += \
     appstyle.cpp \
+    asyncjob.cpp \
+    colorstats.cpp \
+    colortable.cpp \
+    fastlab.cpp \
+    gradient.cpp \
+    gradientpanel.cpp \
+    hdrimage.cpp \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    threadpool.cpp \
+    videopipeline.cpp
 
 HEADERS += \
+    ColorGraph.h \
     ColorModels.h \
     appstyle.h \
-    mainwindow.h
+    asyncjob.h \
+    colorstats.h \
+    colortable.h \
+    fastlab.h \
+    gradient.h \
+    gradientpanel.h \
+    hdrimage.h \
+    mainwindow.h \
+    spscqueue.h \
+    threadpool.h \
+    videopipeline.h
 
 FORMS += \
     mainwindow.ui
@@ -0,0 +1,108 @@
+#pragma once
+#include "ColorModels.h"
+
+#include <cstddef>
+#include <type_traits>
+
+// Граф преобразований между цветовыми моделями, разрешаемый при компиляции.
+//
+// Каждая модель объявляет в Space<T> своего «родителя» (локальный хаб) и
+// две функции: to_parent / from_parent. Вместе они образуют дерево с корнем
+// XYZ:
+//
+//   XYZ ─┬─ Lab ── LCh
+//        └─ LinearRGB ─┬─ RGB ─┬─ HSV
+//                      │       └─ HSL
+//                      ├─ RGB16
+//                      └─ Oklab
+//
+// convert<To>(from) поднимается от From к общему предку и спускается к To.
+// Путь выбирается через if constexpr, все шаги — inline-функции, поэтому
+// компилятор сворачивает цепочку в один вызов без диспетчеризации.
+//
+// Переход LinearRGB -> RGB обрезает цвет до sRGB; если нужен флаг
+// ConvertFlags::outOfGamut, используйте XYZ_to_RGB / LinearRGB_to_RGB.
+namespace Color {
+
+template<class T> struct Space;
+
+template<> struct Space<XYZ> {
+    using Parent = void;
+};
+
+template<> struct Space<Lab> {
+    using Parent = XYZ;
+    static XYZ to_parent(const Lab& c) { return Lab_to_XYZ(c); }
+    static Lab from_parent(const XYZ& c) { return XYZ_to_Lab(c); }
+};
+
+template<> struct Space<LCh> {
+    using Parent = Lab;
+    static Lab to_parent(const LCh& c) { return LCh_to_Lab(c); }
+    static LCh from_parent(const Lab& c) { return Lab_to_LCh(c); }
+};
+
+template<> struct Space<LinearRGB> {
+    using Parent = XYZ;
+    static XYZ to_parent(const LinearRGB& c) { return LinearRGB_to_XYZ(c); }
+    static LinearRGB from_parent(const XYZ& c) { return XYZ_to_LinearRGB(c); }
+};
+
+template<> struct Space<RGB> {
+    using Parent = LinearRGB;
+    static LinearRGB to_parent(const RGB& c) { return RGB_to_LinearRGB(c); }
+    static RGB from_parent(const LinearRGB& c) { return LinearRGB_to_RGB(c).first; }
+};
+
+template<> struct Space<RGB16> {
+    using Parent = LinearRGB;
+    static LinearRGB to_parent(const RGB16& c) { return RGB16_to_LinearRGB(c); }
+    static RGB16 from_parent(const LinearRGB& c) {
+        auto to16 = [](double v) { return std::uint16_t(std::lround(linear_to_srgb(clamp01(v)) * 65535.0)); };
+        return { to16(c.r), to16(c.g), to16(c.b) };
+    }
+};
+
+template<> struct Space<Oklab> {
+    using Parent = LinearRGB;
+    static LinearRGB to_parent(const Oklab& c) { return Oklab_to_LinearRGB(c); }
+    static Oklab from_parent(const LinearRGB& c) { return LinearRGB_to_Oklab(c); }
+};
+
+template<> struct Space<HSV> {
+    using Parent = RGB;
+    static RGB to_parent(const HSV& c) { return HSV_to_RGB(c); }
+    static HSV from_parent(const RGB& c) { return RGB_to_HSV(c); }
+};
+
+template<> struct Space<HSL> {
+    using Parent = RGB;
+    static RGB to_parent(const HSL& c) { return HSL_to_RGB(c); }
+    static HSL from_parent(const RGB& c) { return RGB_to_HSL(c); }
+};
+
+// Глубина модели в дереве (XYZ = 0)
+template<class T>
+constexpr int space_depth() {
+    if constexpr (std::is_void_v<typename Space<T>::Parent>) return 0;
+    else return space_depth<typename Space<T>::Parent>() + 1;
+}
+
+template<class To, class From>
+inline To convert(const From& c) {
+    if constexpr (std::is_same_v<From, To>) {
+        return c;
+    } else if constexpr (space_depth<From>() >= space_depth<To>()) {
+        return convert<To>(Space<From>::to_parent(c));
+    } else {
+        return Space<To>::from_parent(convert<typename Space<To>::Parent>(c));
+    }
+}
+
+// Пакетный вариант: n элементов из in в out
+template<class To, class From>
+inline void convert_batch(const From* in, To* out, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) out[i] = convert<To>(in[i]);
+}
+
+}
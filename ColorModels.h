@@ -1,6 +1,9 @@
 #pragma once
 #include <cmath>
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
 #include <utility>
 
 namespace Color {
@@ -9,6 +12,11 @@ struct RGB { int r{0}, g{0}, b{0}; };
 struct XYZ { double X{0}, Y{0}, Z{0}; };
 struct Lab { double L{0}, a{0}, b{0}; };
 struct HSV { double h{0}, s{0}, v{0}; };
+struct RGB16 { std::uint16_t r{0}, g{0}, b{0}; };     // 16 бит на канал, sRGB-гамма
+struct LinearRGB { double r{0}, g{0}, b{0}; };        // линейный sRGB, 1.0 = белый; > 1.0 допустимо (HDR)
+struct HSL { double h{0}, s{0}, l{0}; };             // h в градусах, s и l 0..1
+struct LCh { double L{0}, C{0}, h{0}; };             // полярная форма Lab, h в градусах
+struct Oklab { double L{0}, a{0}, b{0}; };           // L 0..1
 
 struct ConvertFlags { bool outOfGamut = false; }; // сигнал: цвет был обрезан
 
@@ -17,6 +25,8 @@ static constexpr double Xn = 95.047;
 static constexpr double Yn = 100.000;
 static constexpr double Zn = 108.883;
 
+static constexpr double PI = 3.14159265358979323846;
+
 // --- helpers ---
 inline double clamp01(double x) { return std::clamp(x, 0.0, 1.0); }
 inline int clamp255(double x01) { return (int)std::round(std::clamp(x01, 0.0, 1.0) * 255.0); }
@@ -29,6 +39,38 @@ inline double linear_to_srgb(double u) {
     return (u <= 0.0031308) ? (12.92 * u) : (1.055 * std::pow(u, 1.0 / 2.4) - 0.055);
 }
 
+// 8-битный канал -> линейное значение; таблица на 256 значений вместо pow()
+inline double srgb8_to_linear(int v) {
+    static const auto table = [] {
+        std::array<double, 256> t{};
+        for (int i = 0; i < 256; ++i) t[i] = srgb_to_linear(i / 255.0);
+        return t;
+    }();
+    return (v >= 0 && v <= 255) ? table[v] : srgb_to_linear(v / 255.0);
+}
+
+// 16-битный канал -> линейное значение (float-таблица на 65536 значений)
+inline float srgb16_to_linear(std::uint16_t v) {
+    static const std::vector<float> table = [] {
+        std::vector<float> t(65536);
+        for (int i = 0; i < 65536; ++i) t[i] = float(srgb_to_linear(i / 65535.0));
+        return t;
+    }();
+    return table[v];
+}
+
+// Матрицы linear sRGB <-> XYZ (XYZ в шкале 0..100)
+static constexpr double M_RGB_TO_XYZ[3][3] = {
+    { 0.412453, 0.357580, 0.180423 },
+    { 0.212671, 0.715160, 0.072169 },
+    { 0.019334, 0.119193, 0.950227 },
+};
+static constexpr double M_XYZ_TO_RGB[3][3] = {
+    {  3.2406, -1.5372, -0.4986 },
+    { -0.9689,  1.8758,  0.0415 },
+    {  0.0557, -0.2040,  1.0570 },
+};
+
 // ---------- HSV <-> RGB ----------
 inline HSV RGB_to_HSV(const RGB& rgb) {
     double r = rgb.r / 255.0, g = rgb.g / 255.0, b = rgb.b / 255.0;
@@ -69,23 +111,61 @@ inline RGB HSV_to_RGB(const HSV& hsv) {
     return { clamp255(r1 + m), clamp255(g1 + m), clamp255(b1 + m) };
 }
 
+// ---------- HSL <-> RGB ----------
+inline HSL RGB_to_HSL(const RGB& rgb) {
+    double r = rgb.r / 255.0, g = rgb.g / 255.0, b = rgb.b / 255.0;
+    double cmax = std::max({ r, g, b });
+    double cmin = std::min({ r, g, b });
+    double delta = cmax - cmin;
+
+    HSV hsv = RGB_to_HSV(rgb);   // тон совпадает с HSV
+    double L = (cmax + cmin) / 2.0;
+    double S = (delta <= 1e-12) ? 0.0 : delta / (1.0 - std::fabs(2.0 * L - 1.0));
+    return { hsv.h, clamp01(S), L };
+}
+
+inline RGB HSL_to_RGB(const HSL& hsl) {
+    double S = clamp01(hsl.s);
+    double L = clamp01(hsl.l);
+    double V = L + S * std::min(L, 1.0 - L);
+    double Sv = (V <= 1e-12) ? 0.0 : 2.0 * (1.0 - L / V);
+    return HSV_to_RGB({ hsl.h, Sv, V });
+}
+
+// ---------- linear sRGB <-> XYZ (без обрезки, для HDR) ----------
+inline XYZ LinearRGB_to_XYZ(const LinearRGB& c) {
+    const auto& M = M_RGB_TO_XYZ;
+    return { 100.0 * (M[0][0] * c.r + M[0][1] * c.g + M[0][2] * c.b),
+             100.0 * (M[1][0] * c.r + M[1][1] * c.g + M[1][2] * c.b),
+             100.0 * (M[2][0] * c.r + M[2][1] * c.g + M[2][2] * c.b) };
+}
+
+inline LinearRGB XYZ_to_LinearRGB(const XYZ& xyz) {
+    const auto& M = M_XYZ_TO_RGB;
+    double x = xyz.X / 100.0, y = xyz.Y / 100.0, z = xyz.Z / 100.0;
+    return { M[0][0] * x + M[0][1] * y + M[0][2] * z,
+             M[1][0] * x + M[1][1] * y + M[1][2] * z,
+             M[2][0] * x + M[2][1] * y + M[2][2] * z };
+}
+
+inline LinearRGB RGB_to_LinearRGB(const RGB& rgb) {
+    return { srgb8_to_linear(rgb.r), srgb8_to_linear(rgb.g), srgb8_to_linear(rgb.b) };
+}
+
+inline LinearRGB RGB16_to_LinearRGB(const RGB16& rgb) {
+    return { srgb16_to_linear(rgb.r), srgb16_to_linear(rgb.g), srgb16_to_linear(rgb.b) };
+}
+
 // ---------- RGB <-> XYZ (sRGB, D65) ----------
 inline XYZ RGB_to_XYZ(const RGB& rgb) {
-    double r = srgb_to_linear(rgb.r / 255.0);
-    double g = srgb_to_linear(rgb.g / 255.0);
-    double b = srgb_to_linear(rgb.b / 255.0);
-
-    double X = 100.0 * (0.412453 * r + 0.357580 * g + 0.180423 * b);
-    double Y = 100.0 * (0.212671 * r + 0.715160 * g + 0.072169 * b);
-    double Z = 100.0 * (0.019334 * r + 0.119193 * g + 0.950227 * b);
-    return { X, Y, Z };
+    return LinearRGB_to_XYZ(RGB_to_LinearRGB(rgb));
 }
 
-inline std::pair<RGB, ConvertFlags> XYZ_to_RGB(const XYZ& xyz) {
-    double r_lin =  3.2406 * (xyz.X / 100.0) + (-1.5372) * (xyz.Y / 100.0) + (-0.4986) * (xyz.Z / 100.0);
-    double g_lin = -0.9689 * (xyz.X / 100.0) +  1.8758 * (xyz.Y / 100.0) +  0.0415  * (xyz.Z / 100.0);
-    double b_lin =  0.0557 * (xyz.X / 100.0) + (-0.2040) * (xyz.Y / 100.0) +  1.0570 * (xyz.Z / 100.0);
+inline XYZ RGB16_to_XYZ(const RGB16& rgb) {
+    return LinearRGB_to_XYZ(RGB16_to_LinearRGB(rgb));
+}
 
+inline std::pair<RGB, ConvertFlags> LinearRGB_to_RGB(const LinearRGB& lin) {
     ConvertFlags f;
     constexpr double EPS = 1e-6;
 
@@ -98,7 +178,11 @@ inline std::pair<RGB, ConvertFlags> XYZ_to_RGB(const XYZ& xyz) {
         return (int)std::round(v_srgb * 255.0);
     };
 
-    return { RGB{ to8(r_lin), to8(g_lin), to8(b_lin) }, f };
+    return { RGB{ to8(lin.r), to8(lin.g), to8(lin.b) }, f };
+}
+
+inline std::pair<RGB, ConvertFlags> XYZ_to_RGB(const XYZ& xyz) {
+    return LinearRGB_to_RGB(XYZ_to_LinearRGB(xyz));
 }
 
 
@@ -130,4 +214,37 @@ inline XYZ Lab_to_XYZ(const Lab& lab) {
     return { xr * Xn, yr * Yn, zr * Zn };
 }
 
+// ---------- Lab <-> LCh ----------
+inline LCh Lab_to_LCh(const Lab& lab) {
+    double C = std::hypot(lab.a, lab.b);
+    double h = (C <= 1e-12) ? 0.0 : std::atan2(lab.b, lab.a) * 180.0 / PI;
+    if (h < 0) h += 360.0;
+    return { lab.L, C, h };
+}
+
+inline Lab LCh_to_Lab(const LCh& lch) {
+    double h = lch.h * PI / 180.0;
+    return { lch.L, lch.C * std::cos(h), lch.C * std::sin(h) };
+}
+
+// ---------- linear sRGB <-> Oklab ----------
+inline Oklab LinearRGB_to_Oklab(const LinearRGB& c) {
+    double l = std::cbrt(0.4122214708 * c.r + 0.5363325363 * c.g + 0.0514459929 * c.b);
+    double m = std::cbrt(0.2119034982 * c.r + 0.6806995451 * c.g + 0.1073969566 * c.b);
+    double s = std::cbrt(0.0883024619 * c.r + 0.2817188376 * c.g + 0.6299787005 * c.b);
+    return { 0.2104542553 * l + 0.7936177850 * m - 0.0040720468 * s,
+             1.9779984951 * l - 2.4285922050 * m + 0.4505937099 * s,
+             0.0259040371 * l + 0.7827717662 * m - 0.8086757660 * s };
+}
+
+inline LinearRGB Oklab_to_LinearRGB(const Oklab& o) {
+    double l = o.L + 0.3963377774 * o.a + 0.2158037573 * o.b;
+    double m = o.L - 0.1055613458 * o.a - 0.0638541728 * o.b;
+    double s = o.L - 0.0894841775 * o.a - 1.2914855480 * o.b;
+    l = l * l * l; m = m * m * m; s = s * s * s;
+    return {  4.0767416621 * l - 3.3077115913 * m + 0.2309699292 * s,
+             -1.2684380046 * l + 2.6097574011 * m - 0.3413193965 * s,
+             -0.0041960863 * l - 0.7034186147 * m + 1.7076147010 * s };
+}
+
 }
@@ -1,12 +1,5 @@
-#include "AppStyle.h"
-#include <QGroupBox>
-#include <QPushButton>
-#include <QSlider>
-#include <QSpinBox>
-#include <QDoubleSpinBox>
-#include <QFrame>
+#include "appstyle.h"
 #include <QApplication>
-#include <QLabel>
 
 namespace AppStyle {
 
@@ -16,6 +9,9 @@ static const char* COLOR_TEXT    = "#04070b";  // текст
 static const char* COLOR_ACCENT1 = "#6c91c1";
 static const char* COLOR_ACCENT2 = "#A1B4D9";
 
+// Части таблицы стилей; используются только в appStyleSheet()
+namespace {
+
 QString groupBoxStyle() {
     return QString(R"(
         QGroupBox {
@@ -84,7 +80,7 @@ QString labelStyle() {
 
 QString formLabelStyle() {
     return QString(R"(
-        QLabel {
+        QLabel#formLabel {
             font-size: 13pt;
             font-weight: bold;
             color: #004B6A;
@@ -92,28 +88,35 @@ QString formLabelStyle() {
     )");
 }
 
-void applyAppStyle(QWidget *root) {
-    if (!root) return;
+} // namespace
+
+QString appStyleSheet() {
+    // собирается один раз; правила для конкретных типов идут после общего фона
+    static const QString sheet =
+        QString("QWidget { background: %1; }\n").arg(COLOR_BG)
+        + groupBoxStyle()
+        + buttonStyle()
+        + sliderStyle()
+        + labelStyle()
+        + formLabelStyle();
+    return sheet;
+}
 
-    root->setStyleSheet(QString("background: %1;").arg(COLOR_BG));
+QFont displayFont(int pointSize, int weight) {
+#ifdef Q_OS_WIN
+    return QFont("Segoe Print", pointSize, weight);
+#else
+    // на других системах "Segoe Print" нет, и поиск замены замедляет запуск
+    QFont f = QApplication::font();
+    f.setPointSize(pointSize);
+    f.setWeight(QFont::Weight(weight));
+    return f;
+#endif
+}
 
-    const auto widgets = root->findChildren<QWidget*>();
-    for (QWidget *w : widgets) {
-        if (qobject_cast<QGroupBox*>(w)) {
-            w->setStyleSheet(groupBoxStyle());
-        } else if (qobject_cast<QPushButton*>(w)) {
-            w->setStyleSheet(buttonStyle());
-        } else if (qobject_cast<QSlider*>(w)) {
-            w->setStyleSheet(sliderStyle());
-        } else if (auto *lbl = qobject_cast<QLabel*>(w)) {
-            if (lbl->objectName() == "formLabel")
-                lbl->setStyleSheet(formLabelStyle());
-            else
-                lbl->setStyleSheet(labelStyle());
-        } else if (qobject_cast<QFrame*>(w) && w->objectName() == "previewFrame") {
-            w->setStyleSheet(QString("border:1px solid %1; border-radius:12px;").arg(COLOR_BORDER));
-        }
-    }
+void applyAppStyle(QApplication *app) {
+    if (!app) return;
+    app->setStyleSheet(appStyleSheet());
 }
 
 }
@@ -1,20 +1,22 @@
 #ifndef APPSTYLE_H
 #define APPSTYLE_H
 
+#include <QFont>
 #include <QString>
-#include <QWidget>
+
+class QApplication;
 
 namespace AppStyle {
 
-// Применить общий стиль ко всему приложению
-void applyAppStyle(QWidget *root);
+// Применить общий стиль ко всему приложению: одна таблица стилей на уровне
+// QApplication вместо отдельных стилей каждого виджета
+void applyAppStyle(QApplication *app);
+
+// Вся таблица стилей приложения (собирается при первом вызове)
+QString appStyleSheet();
 
-// Вернуть стили для отдельных виджетов
-QString groupBoxStyle();
-QString buttonStyle();
-QString sliderStyle();
-QString spinBoxStyle();
-QString formLabelStyle();
+// Шрифт заголовков; "Segoe Print" только там, где он есть (Windows)
+QFont displayFont(int pointSize, int weight = QFont::Normal);
 
 }
 
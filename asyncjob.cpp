@@ -0,0 +1,117 @@
+#include "asyncjob.h"
+
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace Async {
+
+static constexpr qint64 PROGRESS_INTERVAL_MS = 50;
+
+Job::Job(QObject *receiver, ProgressFn onProgress)
+    : m_receiver(receiver), m_onProgress(std::move(onProgress))
+{
+    m_clock.start();
+}
+
+void Job::reportProgress(qint64 done, qint64 total)
+{
+    if (!m_onProgress) return;
+    const qint64 now = m_clock.elapsed();
+    qint64 last = m_lastReportMs.load(std::memory_order_relaxed);
+    if (done < total && now - last < PROGRESS_INTERVAL_MS) return;
+    // из нескольких потоков одновременно отправит только один
+    if (!m_lastReportMs.compare_exchange_strong(last, now, std::memory_order_relaxed)) return;
+
+    ProgressFn fn = m_onProgress;
+    QMetaObject::invokeMethod(m_receiver, [fn, done, total]() { fn(done, total); },
+                              Qt::QueuedConnection);
+}
+
+void Job::wait()
+{
+    std::unique_lock<std::mutex> lk(m_mutex);
+    m_finishedCv.wait(lk, [this]{ return m_finished; });
+}
+
+void Job::finish()
+{
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_finished = true;
+    m_finishedCv.notify_all();
+}
+
+namespace {
+
+// Поток-диспетчер: одна задача за раз, старший приоритет первым,
+// при равном — в порядке постановки
+class Dispatcher {
+public:
+    static Dispatcher &instance() {
+        static Dispatcher d;
+        return d;
+    }
+
+    ~Dispatcher() {
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+
+    void submit(std::function<void()> task, Priority priority) {
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            m_tasks.push({ int(priority), m_seq++, std::move(task) });
+        }
+        m_wake.notify_one();
+    }
+
+private:
+    struct Item {
+        int priority;
+        quint64 seq;
+        std::function<void()> fn;
+
+        bool operator<(const Item &o) const {
+            return priority != o.priority ? priority < o.priority : seq > o.seq;
+        }
+    };
+
+    Dispatcher() : m_thread([this]{ loop(); }) {}
+
+    void loop() {
+        std::unique_lock<std::mutex> lk(m_mutex);
+        for (;;) {
+            m_wake.wait(lk, [this]{ return m_stop || !m_tasks.empty(); });
+            if (m_stop) return;
+            std::function<void()> fn = std::move(const_cast<Item&>(m_tasks.top()).fn);
+            m_tasks.pop();
+            lk.unlock();
+            fn();
+            lk.lock();
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::priority_queue<Item> m_tasks;
+    quint64 m_seq = 0;
+    bool m_stop = false;
+    std::thread m_thread;   // последним: стартует после остальных полей
+};
+
+}
+
+namespace detail {
+
+void submit(std::function<void()> task, Priority priority)
+{
+    Dispatcher::instance().submit(std::move(task), priority);
+}
+
+}
+
+}
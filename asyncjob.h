@@ -0,0 +1,80 @@
+#pragma once
+#include <QElapsedTimer>
+#include <QMetaObject>
+#include <QObject>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+// Асинхронные задачи для долгих конвертаций.
+//
+// Async::run ставит work(job) в очередь единственного потока-диспетчера и
+// возвращает управление сразу. Задачи выполняются по одной в порядке
+// приоритета; тяжёлая работа внутри них раскладывается в общий ThreadPool,
+// поэтому второго пула на все ядра нет. Прогресс и результат доставляются в
+// поток receiver через его цикл событий, поэтому колбэки могут трогать виджеты.
+// Отмена кооперативная: work периодически проверяет job.isCancelled().
+// receiver должен жить до завершения задачи (или дождаться её через wait()).
+namespace Async {
+
+enum class Priority { Low = 0, Normal = 5, High = 10 };
+
+using ProgressFn = std::function<void(qint64 done, qint64 total)>;
+
+class Job {
+public:
+    Job(QObject *receiver, ProgressFn onProgress);
+
+    void cancel() { m_cancelled.store(true, std::memory_order_relaxed); }
+    bool isCancelled() const { return m_cancelled.load(std::memory_order_relaxed); }
+
+    // Вызывается из work; в цикл событий уходит не чаще раза в 50 мс
+    // (и всегда при done == total)
+    void reportProgress(qint64 done, qint64 total);
+
+    // Дождаться окончания work (onDone в цикле событий может быть ещё впереди)
+    void wait();
+    // Вызывается Async::run после work
+    void finish();
+
+private:
+    QObject *m_receiver;
+    ProgressFn m_onProgress;
+    QElapsedTimer m_clock;
+    std::atomic<bool> m_cancelled{false};
+    std::atomic<qint64> m_lastReportMs{-1000};
+
+    std::mutex m_mutex;
+    std::condition_variable m_finishedCv;
+    bool m_finished = false;
+};
+
+using JobPtr = std::shared_ptr<Job>;
+
+namespace detail {
+
+// Поставить задачу в очередь потока-диспетчера
+void submit(std::function<void()> task, Priority priority);
+
+}
+
+// work: R(Job&), onDone: void(R) — вызывается в потоке receiver
+template<class Work, class Done>
+JobPtr run(QObject *receiver, Work work, Done onDone,
+           ProgressFn onProgress = {}, Priority priority = Priority::Normal)
+{
+    auto job = std::make_shared<Job>(receiver, std::move(onProgress));
+    detail::submit([job, receiver, work, onDone]() {
+        auto result = work(*job);
+        QMetaObject::invokeMethod(receiver, [onDone, result]() { onDone(result); },
+                                  Qt::QueuedConnection);
+        job->finish();
+    }, priority);
+    return job;
+}
+
+}
@@ -0,0 +1,265 @@
+#include "colorstats.h"
+#include "fastlab.h"
+#include "threadpool.h"
+
+#include <QColor>
+#include <algorithm>
+
+namespace ColorStats {
+
+namespace {
+
+// Строк в одном блоке пула: около 256K пикселей
+std::size_t rowsPerChunk(int width) {
+    return std::max<std::size_t>(1, (std::size_t(1) << 18) / std::size_t(std::max(1, width)));
+}
+
+// 8-битный пиксель: Lab и HSV по таблицам FastLab
+inline void addRGB(Accumulator::Partial &p, const FastLab::Tables &t, int r, int g, int b) {
+    float lab[3], hsv[3];
+    FastLab::rgbToLab(t, r, g, b, lab);
+    FastLab::rgbToHSV(r, g, b, hsv);
+    p.add({ lab[0], lab[1], lab[2] }, { hsv[0], hsv[1], hsv[2] }, false);
+}
+
+// Линейный пиксель: значения вне 0..1 считаются вне гаммы
+inline void addLinear(Accumulator::Partial &p, const Color::LinearRGB &lin) {
+    auto conv = Color::LinearRGB_to_RGB(lin);
+    const Color::Lab lab = Color::XYZ_to_Lab(Color::LinearRGB_to_XYZ(lin));
+    p.add(lab, Color::RGB_to_HSV(conv.first), conv.second.outOfGamut);
+}
+
+// Строка RGBA64 (R,G,B,A по 16 бит, sRGB-гамма)
+inline void add16Row(Accumulator::Partial &p, const quint16 *px, int width) {
+    for (int x = 0; x < width; ++x, px += 4)
+        addLinear(p, { Color::srgb16_to_linear(px[0]), Color::srgb16_to_linear(px[1]),
+                       Color::srgb16_to_linear(px[2]) });
+}
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 2, 0)
+// sRGB-гамма для float-каналов, продолженная на значения вне 0..1
+inline double srgbFloatToLinear(float u) {
+    return u < 0.f ? -Color::srgb_to_linear(-u) : Color::srgb_to_linear(u);
+}
+
+// Строка RGBA32FPx4 (sRGB-гамма, значения могут выходить за 0..1)
+inline void addFloatRow(Accumulator::Partial &p, const float *px, int width) {
+    for (int x = 0; x < width; ++x, px += 4) {
+        if (!std::isfinite(px[0]) || !std::isfinite(px[1]) || !std::isfinite(px[2])) continue;
+        addLinear(p, { srgbFloatToLinear(px[0]), srgbFloatToLinear(px[1]), srgbFloatToLinear(px[2]) });
+    }
+}
+#endif
+
+} // namespace
+
+void Accumulator::Partial::add(const Color::Lab &lab, const Color::HSV &hsv, bool outOfGamut) {
+    ++n;
+    if (outOfGamut) ++oog;
+    sum[0] += lab.L; sum[1] += lab.a; sum[2] += lab.b;
+    sumProd[0] += lab.L * lab.L; sumProd[1] += lab.L * lab.a; sumProd[2] += lab.L * lab.b;
+    sumProd[3] += lab.a * lab.a; sumProd[4] += lab.a * lab.b; sumProd[5] += lab.b * lab.b;
+    sumS += hsv.s;
+    sumV += hsv.v;
+
+    const int li = int(std::lround(std::clamp(lab.L, 0.0, 100.0) * 10.0));
+    ++lHist[li];
+    if (hsv.s > 0.0) {
+        ++chromatic;
+        ++hueHist[std::min(HUE_BINS - 1, int(hsv.h))];
+    }
+    const int ci = int(std::min(double(CHROMA_BINS - 1), std::sqrt(lab.a * lab.a + lab.b * lab.b)));
+    ++chromaHist[ci];
+}
+
+void Accumulator::Partial::merge(const Partial &o) {
+    n += o.n; oog += o.oog; chromatic += o.chromatic;
+    for (int i = 0; i < 3; ++i) sum[i] += o.sum[i];
+    for (int i = 0; i < 6; ++i) sumProd[i] += o.sumProd[i];
+    sumS += o.sumS; sumV += o.sumV;
+    for (int i = 0; i < L_BINS; ++i) lHist[i] += o.lHist[i];
+    for (int i = 0; i < HUE_BINS; ++i) hueHist[i] += o.hueHist[i];
+    for (int i = 0; i < CHROMA_BINS; ++i) chromaHist[i] += o.chromaHist[i];
+}
+
+template<class ChunkFn>
+void Accumulator::accumulateChunks(int height, int width, const ChunkFn &chunkFn) {
+    ThreadPool::instance().parallelFor(std::size_t(height), rowsPerChunk(width),
+        [&](std::size_t y0, std::size_t y1) {
+            Partial part;
+            chunkFn(int(y0), int(y1), part);
+            mergePartial(part);
+        });
+}
+
+template<class RowFn>
+void Accumulator::accumulateRows(int height, int width, const RowFn &rowFn) {
+    accumulateChunks(height, width, [&](int y0, int y1, Partial &part) {
+        for (int y = y0; y < y1; ++y) rowFn(y, part);
+    });
+}
+
+void Accumulator::mergePartial(const Partial &p) {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_total.merge(p);
+}
+
+void Accumulator::merge(const Accumulator &other) {
+    if (&other == this) return;
+    Partial copy;
+    {
+        std::lock_guard<std::mutex> lk(other.m_mutex);
+        copy = other.m_total;
+    }
+    mergePartial(copy);
+}
+
+void Accumulator::addRGB8(const std::uint8_t *pixels, int width, int height, std::size_t bytesPerLine, int channels) {
+    if (!pixels || width <= 0 || height <= 0 || (channels != 3 && channels != 4)) return;
+    const FastLab::Tables &t = FastLab::tables();
+    accumulateRows(height, width, [&](int y, Partial &part) {
+        const std::uint8_t *px = pixels + bytesPerLine * std::size_t(y);
+        for (int x = 0; x < width; ++x, px += channels)
+            addRGB(part, t, px[0], px[1], px[2]);
+    });
+}
+
+void Accumulator::addLinearFloat(const float *pixels, int width, int height, std::size_t stride, int channels) {
+    if (!pixels || width <= 0 || height <= 0 || (channels != 3 && channels != 4)) return;
+    accumulateRows(height, width, [&](int y, Partial &part) {
+        const float *px = pixels + stride * std::size_t(y);
+        for (int x = 0; x < width; ++x, px += channels) {
+            if (!std::isfinite(px[0]) || !std::isfinite(px[1]) || !std::isfinite(px[2])) continue;
+            addLinear(part, { px[0], px[1], px[2] });
+        }
+    });
+}
+
+void Accumulator::addImage(const QImage &image) {
+    if (image.isNull()) return;
+    const int w = image.width();
+    switch (image.format()) {
+    case QImage::Format_RGBA8888:
+    case QImage::Format_RGBX8888:
+        addRGB8(image.constBits(), w, image.height(), std::size_t(image.bytesPerLine()), 4);
+        return;
+    case QImage::Format_RGB888:
+        addRGB8(image.constBits(), w, image.height(), std::size_t(image.bytesPerLine()), 3);
+        return;
+    case QImage::Format_RGB32:
+    case QImage::Format_ARGB32: {
+        const FastLab::Tables &t = FastLab::tables();
+        accumulateRows(image.height(), w, [&](int y, Partial &part) {
+            const QRgb *px = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+            for (int x = 0; x < w; ++x)
+                addRGB(part, t, qRed(px[x]), qGreen(px[x]), qBlue(px[x]));
+        });
+        return;
+    }
+    case QImage::Format_RGBA64:
+    case QImage::Format_RGBX64:
+        accumulateRows(image.height(), w, [&](int y, Partial &part) {
+            add16Row(part, reinterpret_cast<const quint16*>(image.constScanLine(y)), w);
+        });
+        return;
+#if QT_VERSION >= QT_VERSION_CHECK(6, 2, 0)
+    case QImage::Format_RGBA32FPx4:
+    case QImage::Format_RGBX32FPx4:
+        accumulateRows(image.height(), w, [&](int y, Partial &part) {
+            addFloatRow(part, reinterpret_cast<const float*>(image.constScanLine(y)), w);
+        });
+        return;
+    case QImage::Format_RGBA32FPx4_Premultiplied:
+    case QImage::Format_RGBA16FPx4:
+    case QImage::Format_RGBX16FPx4:
+    case QImage::Format_RGBA16FPx4_Premultiplied:
+        // каждый блок пула переводит в RGBA32FPx4 только свои строки
+        accumulateChunks(image.height(), w, [&](int y0, int y1, Partial &part) {
+            const QImage rows = image.copy(0, y0, w, y1 - y0).convertToFormat(QImage::Format_RGBA32FPx4);
+            for (int y = 0; y < rows.height(); ++y)
+                addFloatRow(part, reinterpret_cast<const float*>(rows.constScanLine(y)), w);
+        });
+        return;
+#endif
+    default: {
+        // прочие форматы переводим в блоках пула: больше 8 бит на канал — в RGBA64,
+        // иначе в RGBA8888
+        const QPixelFormat pf = image.pixelFormat();
+        const bool deep = std::max<int>(pf.redSize(), pf.brightnessSize()) > 8;
+        accumulateChunks(image.height(), w, [&](int y0, int y1, Partial &part) {
+            const QImage rows = image.copy(0, y0, w, y1 - y0)
+                .convertToFormat(deep ? QImage::Format_RGBA64 : QImage::Format_RGBA8888);
+            for (int y = 0; y < rows.height(); ++y) {
+                if (deep) {
+                    add16Row(part, reinterpret_cast<const quint16*>(rows.constScanLine(y)), w);
+                    continue;
+                }
+                const std::uint8_t *px = rows.constScanLine(y);
+                for (int x = 0; x < w; ++x, px += 4)
+                    addRGB(part, FastLab::tables(), px[0], px[1], px[2]);
+            }
+        });
+        return;
+    }
+    }
+}
+
+int stripRows(int width) {
+    return int(rowsPerChunk(width)) * ThreadPool::instance().concurrency();
+}
+
+bool canBeOutOfGamut(const QImage &image) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 2, 0)
+    return image.pixelFormat().typeInterpretation() == QPixelFormat::FloatingPoint;
+#else
+    Q_UNUSED(image);
+    return false;
+#endif
+}
+
+Result Accumulator::result() const {
+    Partial t;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        t = m_total;
+    }
+
+    Result r;
+    r.pixels = t.n;
+    r.outOfGamut = t.oog;
+    r.chromatic = t.chromatic;
+    r.lHist = t.lHist;
+    r.hueHist = t.hueHist;
+    r.chromaHist = t.chromaHist;
+    if (t.n == 0) return r;
+
+    const double n = double(t.n);
+    const double m[3] = { t.sum[0] / n, t.sum[1] / n, t.sum[2] / n };
+    r.mean = { m[0], m[1], m[2] };
+    static const int idx[3][3] = { { 0, 1, 2 }, { 1, 3, 4 }, { 2, 4, 5 } };
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            r.cov[i][j] = t.sumProd[idx[i][j]] / n - m[i] * m[j];
+    r.meanSaturation = t.sumS / n;
+    r.meanValue = t.sumV / n;
+    return r;
+}
+
+double Result::percentileL(double p) const {
+    if (pixels == 0) return 0.0;
+    const double target = std::clamp(p, 0.0, 100.0) / 100.0 * double(pixels);
+    std::uint64_t cum = 0;
+    for (int i = 0; i < L_BINS; ++i) {
+        cum += lHist[i];
+        if (double(cum) >= target && cum > 0) return i / 10.0;
+    }
+    return 100.0;
+}
+
+Result analyze(const QImage &image) {
+    Accumulator acc;
+    acc.addImage(image);
+    return acc.result();
+}
+
+}
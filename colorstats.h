@@ -0,0 +1,89 @@
+#pragma once
+#include "ColorModels.h"
+
+#include <QImage>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// Статистика цвета изображения за один проход: средний Lab и ковариация,
+// перцентили L, гистограммы тона (HSV) и хромы (LCh), доля цветов вне sRGB.
+//
+// Блок пикселей делится на полосы строк и обрабатывается в ThreadPool;
+// каждая полоса копит свои гистограммы, которые затем сливаются.
+// Accumulator позволяет подавать изображение частями (потоковый режим).
+namespace ColorStats {
+
+static constexpr int L_BINS      = 1001;  // L 0..100 с шагом 0.1
+static constexpr int HUE_BINS    = 360;   // 1°
+static constexpr int CHROMA_BINS = 151;   // C 0..149 с шагом 1, последняя — 150 и выше
+
+struct Result {
+    std::uint64_t pixels = 0;
+    std::uint64_t outOfGamut = 0;
+    std::uint64_t chromatic = 0;       // пиксели с s > 0 (попали в hueHist)
+
+    Color::Lab mean;
+    double cov[3][3] = {};             // ковариация (L, a, b)
+    double meanSaturation = 0.0;       // HSV s, 0..1
+    double meanValue = 0.0;            // HSV v, 0..1
+
+    std::array<std::uint64_t, L_BINS> lHist{};
+    std::array<std::uint64_t, HUE_BINS> hueHist{};
+    std::array<std::uint64_t, CHROMA_BINS> chromaHist{};
+
+    double outOfGamutFraction() const { return pixels ? double(outOfGamut) / double(pixels) : 0.0; }
+    // p в диапазоне 0..100; точность — ширина корзины (0.1 L)
+    double percentileL(double p) const;
+};
+
+class Accumulator {
+public:
+    // 8-битный sRGB: channels = 3 (RGB) или 4 (RGBA), байты в порядке R,G,B[,A]
+    void addRGB8(const std::uint8_t *pixels, int width, int height, std::size_t bytesPerLine, int channels);
+    // Линейный float32 RGB(A); значения вне 0..1 считаются вне гаммы
+    void addLinearFloat(const float *pixels, int width, int height, std::size_t stride, int channels);
+    // 8-битные форматы идут через таблицы, 16-битные и float — через линейный путь;
+    // прочие переводятся блоками внутри пула, без копии всего кадра
+    void addImage(const QImage &image);
+
+    void merge(const Accumulator &other);
+    Result result() const;
+
+    struct Partial {
+        std::uint64_t n = 0, oog = 0, chromatic = 0;
+        double sum[3] = {};
+        double sumProd[6] = {};        // LL, La, Lb, aa, ab, bb
+        double sumS = 0.0, sumV = 0.0;
+        std::array<std::uint64_t, L_BINS> lHist{};
+        std::array<std::uint64_t, HUE_BINS> hueHist{};
+        std::array<std::uint64_t, CHROMA_BINS> chromaHist{};
+
+        void add(const Color::Lab &lab, const Color::HSV &hsv, bool oog);
+        void merge(const Partial &o);
+    };
+
+private:
+    // Обойти строки [0, height) в пуле; chunkFn(y0, y1, partial) обрабатывает блок строк
+    template<class ChunkFn>
+    void accumulateChunks(int height, int width, const ChunkFn &chunkFn);
+    // То же построчно: rowFn(y, partial)
+    template<class RowFn>
+    void accumulateRows(int height, int width, const RowFn &rowFn);
+    void mergePartial(const Partial &p);
+
+    mutable std::mutex m_mutex;
+    Partial m_total;
+};
+
+// Один проход по всему изображению
+Result analyze(const QImage &image);
+
+// Высота полосы для подачи изображения частями: не меньше блока на каждый поток пула
+int stripRows(int width);
+
+// Может ли формат хранить цвета вне sRGB (float); для остальных outOfGamut == 0
+bool canBeOutOfGamut(const QImage &image);
+
+}
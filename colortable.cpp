@@ -0,0 +1,468 @@
+#include "colortable.h"
+#include "threadpool.h"
+
+#include <QFile>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ColorTable {
+
+namespace {
+
+// Верхняя граница длины одной выходной строки (JSON с ключами, 13 чисел).
+constexpr std::size_t MAX_ROW_BYTES = 512;
+constexpr int POOL_CHUNKS = 4;
+// Строк в блоке, который один поток пула разбирает, конвертирует и форматирует
+constexpr std::size_t BLOCK_ROWS = 1024;
+
+struct Row {
+    Color::RGB rgb;
+    Color::HSV hsv;
+    Color::XYZ xyz;
+    Color::Lab lab;
+    bool oog = false;
+};
+
+struct Line {
+    const char *begin;
+    const char *end;
+};
+
+// Результат обработки блока: сколько байт вывода и строк каждого вида.
+struct Block {
+    std::size_t bytes = 0;
+    std::size_t rows = 0;
+    std::size_t bad = 0;
+    std::size_t oog = 0;
+};
+
+// Чанк конвейера: диапазон входных строк, блоки и буфер вывода.
+// Блок k пишет в out с позиции k * BLOCK_ROWS * MAX_ROW_BYTES.
+// Память выделяется один раз при создании пула и затем переиспользуется.
+struct Chunk {
+    std::vector<Line> lines;
+    std::vector<Block> blocks;
+    std::vector<char> out;
+    std::size_t count = 0;
+    std::size_t inEnd = 0;       // смещение конца разобранного диапазона во входе
+};
+
+// Простая ограниченная очередь указателей на чанки.
+class ChunkQueue {
+public:
+    bool push(Chunk *c) {
+        std::unique_lock<std::mutex> lk(m);
+        if (closed) return false;
+        items.push_back(c);
+        cv.notify_one();
+        return true;
+    }
+    bool pop(Chunk *&c) {
+        std::unique_lock<std::mutex> lk(m);
+        cv.wait(lk, [&]{ return closed || !items.empty(); });
+        if (items.empty()) return false;
+        c = items.front();
+        items.pop_front();
+        return true;
+    }
+    void close() {
+        std::lock_guard<std::mutex> lk(m);
+        closed = true;
+        cv.notify_all();
+    }
+
+private:
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<Chunk*> items;
+    bool closed = false;
+};
+
+// ---------- разбор ----------
+
+inline const char *skipSpaces(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    return p;
+}
+
+inline bool parseNumber(const char *&p, const char *end, double &v) {
+    p = skipSpaces(p, end);
+    if (p < end && *p == '"') ++p;
+    if (p < end && *p == '+') ++p;
+    auto res = std::from_chars(p, end, v);
+    // from_chars принимает nan / inf — такие строки считаются ошибочными
+    if (res.ec != std::errc() || !std::isfinite(v)) return false;
+    p = res.ptr;
+    if (p < end && *p == '"') ++p;
+    return true;
+}
+
+inline bool parseHex(const char *&p, const char *end, Color::RGB &rgb) {
+    p = skipSpaces(p, end);
+    if (p < end && *p == '"') ++p;
+    if (p < end && *p == '#') ++p;
+    if (end - p < 6) return false;
+    unsigned v = 0;
+    auto res = std::from_chars(p, p + 6, v, 16);
+    if (res.ec != std::errc() || res.ptr != p + 6) return false;
+    p += 6;
+    if (p < end && *p == '"') ++p;
+    rgb = { int((v >> 16) & 0xFF), int((v >> 8) & 0xFF), int(v & 0xFF) };
+    return true;
+}
+
+// Сдвинуть p на начало колонки с индексом col (CSV).
+inline bool seekColumn(const char *&p, const char *end, int col) {
+    for (; col > 0; --col) {
+        const void *comma = std::memchr(p, ',', std::size_t(end - p));
+        if (!comma) return false;
+        p = static_cast<const char*>(comma) + 1;
+    }
+    return true;
+}
+
+inline bool nextField(const char *&p, const char *end) {
+    p = skipSpaces(p, end);
+    if (p >= end || *p != ',') return false;
+    ++p;
+    return true;
+}
+
+// Найти значение ключа "key" в JSON-объекте строки.
+inline const char *findJsonValue(const char *p, const char *end, const char *key) {
+    const std::size_t klen = std::strlen(key);
+    while (p < end) {
+        const void *q = std::memchr(p, '"', std::size_t(end - p));
+        if (!q) return nullptr;
+        const char *s = static_cast<const char*>(q) + 1;
+        if (std::size_t(end - s) > klen && std::memcmp(s, key, klen) == 0 && s[klen] == '"') {
+            const char *v = skipSpaces(s + klen + 1, end);
+            if (v < end && *v == ':') return v + 1;
+        }
+        p = s;
+    }
+    return nullptr;
+}
+
+bool parseTriple(const char *p, const char *end, const Options &opt, double v[3]) {
+    if (opt.inFormat == Format::Csv) {
+        return parseNumber(p, end, v[0]) && nextField(p, end)
+            && parseNumber(p, end, v[1]) && nextField(p, end)
+            && parseNumber(p, end, v[2]);
+    }
+    static const char *keys[][3] = {
+        { "r", "g", "b" }, { "h", "s", "v" }, { "X", "Y", "Z" }, { "L", "A", "B" }
+    };
+    const auto &k = keys[int(opt.source) - int(Source::RGB)];
+    for (int i = 0; i < 3; ++i) {
+        const char *q = findJsonValue(p, end, k[i]);
+        if (!q || !parseNumber(q, end, v[i])) return false;
+    }
+    return true;
+}
+
+// Разобрать исходный цвет строки в Row::rgb / hsv / xyz / lab (по Source).
+bool parseRow(const char *p, const char *end, const Options &opt, Row &row) {
+    if (opt.inFormat == Format::Csv && !seekColumn(p, end, opt.column)) return false;
+
+    if (opt.source == Source::Hex) {
+        if (opt.inFormat == Format::JsonLines) {
+            p = findJsonValue(p, end, "hex");
+            if (!p) return false;
+        }
+        return parseHex(p, end, row.rgb);
+    }
+
+    double v[3];
+    if (!parseTriple(p, end, opt, v)) return false;
+    switch (opt.source) {
+    case Source::RGB: row.rgb = { int(std::lround(v[0])), int(std::lround(v[1])), int(std::lround(v[2])) }; break;
+    case Source::HSV: row.hsv = { v[0], v[1], v[2] }; break;
+    case Source::XYZ: row.xyz = { v[0], v[1], v[2] }; break;
+    case Source::Lab: row.lab = { v[0], v[1], v[2] }; break;
+    default: break;
+    }
+    return true;
+}
+
+// ---------- конвертация ----------
+
+void convertRow(Row &r, Source src) {
+    switch (src) {
+    case Source::Hex:
+    case Source::RGB:
+        r.rgb = { std::clamp(r.rgb.r, 0, 255), std::clamp(r.rgb.g, 0, 255), std::clamp(r.rgb.b, 0, 255) };
+        r.hsv = Color::RGB_to_HSV(r.rgb);
+        r.xyz = Color::RGB_to_XYZ(r.rgb);
+        r.lab = Color::XYZ_to_Lab(r.xyz);
+        break;
+    case Source::HSV:
+        r.rgb = Color::HSV_to_RGB(r.hsv);
+        r.xyz = Color::RGB_to_XYZ(r.rgb);
+        r.lab = Color::XYZ_to_Lab(r.xyz);
+        break;
+    case Source::Lab:
+        r.xyz = Color::Lab_to_XYZ(r.lab);
+        [[fallthrough]];
+    case Source::XYZ: {
+        auto conv = Color::XYZ_to_RGB(r.xyz);
+        r.rgb = conv.first;
+        r.oog = conv.second.outOfGamut;
+        r.hsv = Color::RGB_to_HSV(r.rgb);
+        if (src == Source::XYZ) r.lab = Color::XYZ_to_Lab(r.xyz);
+        break;
+    }
+    }
+}
+
+// ---------- форматирование ----------
+
+inline char *putText(char *p, const char *s) {
+    const std::size_t n = std::strlen(s);
+    std::memcpy(p, s, n);
+    return p + n;
+}
+
+inline char *putInt(char *p, int v) {
+    return std::to_chars(p, p + 16, v).ptr;
+}
+
+// Число с фиксированным числом знаков после точки, без хвостовых нулей.
+// Заметно дешевле std::to_chars(general): целое округление и цифры по таблице.
+inline char *putFixed(char *p, double v, int decimals) {
+    static const double scale[] = { 1, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6 };
+    static const long long pow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+    if (!(std::fabs(v) < 1e12)) {
+        auto res = std::to_chars(p, p + 32, v, std::chars_format::general, 7);
+        return res.ec == std::errc() ? res.ptr : putText(p, "0");
+    }
+    long long n = std::llround(v * scale[decimals]);
+    if (n < 0) { *p++ = '-'; n = -n; }
+    else if (n == 0) { *p++ = '0'; return p; }
+    long long ip = n / pow10[decimals];
+    long long fp = n % pow10[decimals];
+    p = std::to_chars(p, p + 24, ip).ptr;
+    if (fp == 0) return p;
+    while (fp % 10 == 0) { fp /= 10; --decimals; }
+    *p++ = '.';
+    for (int i = decimals - 1; i >= 0; --i) {
+        p[i] = char('0' + fp % 10);
+        fp /= 10;
+    }
+    return p + decimals;
+}
+
+inline char *putHex(char *p, const Color::RGB &c) {
+    static const char digits[] = "0123456789abcdef";
+    *p++ = '#';
+    for (int v : { c.r, c.g, c.b }) {
+        *p++ = digits[(v >> 4) & 0xF];
+        *p++ = digits[v & 0xF];
+    }
+    return p;
+}
+
+// Знаков после точки для h,s,v,X,Y,Z,L,A,B: не меньше точности 8-битного цвета
+constexpr int DECIMALS[9] = { 3, 5, 5, 4, 4, 4, 4, 4, 4 };
+
+char *formatRow(char *p, const Row &r, Format fmt) {
+    const double vals[] = { r.hsv.h, r.hsv.s, r.hsv.v, r.xyz.X, r.xyz.Y, r.xyz.Z, r.lab.L, r.lab.a, r.lab.b };
+    if (fmt == Format::Csv) {
+        p = putHex(p, r.rgb);
+        *p++ = ','; p = putInt(p, r.rgb.r);
+        *p++ = ','; p = putInt(p, r.rgb.g);
+        *p++ = ','; p = putInt(p, r.rgb.b);
+        for (int i = 0; i < 9; ++i) {
+            *p++ = ',';
+            p = putFixed(p, vals[i], DECIMALS[i]);
+        }
+        *p++ = ',';
+        *p++ = r.oog ? '1' : '0';
+        *p++ = '\n';
+        return p;
+    }
+
+    p = putText(p, "{\"hex\":\"");
+    p = putHex(p, r.rgb);
+    p = putText(p, "\",\"r\":"); p = putInt(p, r.rgb.r);
+    p = putText(p, ",\"g\":");   p = putInt(p, r.rgb.g);
+    p = putText(p, ",\"b\":");   p = putInt(p, r.rgb.b);
+    static const char *keys[] = { ",\"h\":", ",\"s\":", ",\"v\":", ",\"X\":", ",\"Y\":", ",\"Z\":",
+                                  ",\"L\":", ",\"A\":", ",\"B\":" };
+    for (int i = 0; i < 9; ++i) {
+        p = putText(p, keys[i]);
+        p = putFixed(p, vals[i], DECIMALS[i]);
+    }
+    p = putText(p, r.oog ? ",\"oog\":true}\n" : ",\"oog\":false}\n");
+    return p;
+}
+
+// Разобрать, сконвертировать и отформатировать строки [begin, end) чанка.
+void processBlock(Chunk &c, std::size_t k, const Options &opt) {
+    const std::size_t begin = k * BLOCK_ROWS;
+    const std::size_t end = std::min(c.count, begin + BLOCK_ROWS);
+    char *const start = c.out.data() + begin * MAX_ROW_BYTES;
+    char *p = start;
+    Block &b = c.blocks[k];
+    b = Block{};
+    for (std::size_t i = begin; i < end; ++i) {
+        Row row;
+        if (!parseRow(c.lines[i].begin, c.lines[i].end, opt, row)) {
+            ++b.bad;
+            continue;
+        }
+        convertRow(row, opt.source);
+        p = formatRow(p, row, opt.outFormat);
+        ++b.rows;
+        b.oog += row.oog ? 1 : 0;
+    }
+    b.bytes = std::size_t(p - start);
+}
+
+} // namespace
+
+Stats convertBuffer(const char *data, std::size_t size, const Options &opt, const Sink &sink)
+{
+    Stats st;
+    st.inBytes = size;
+    const auto t0 = std::chrono::steady_clock::now();
+    const std::size_t chunkRows = std::max<std::size_t>(opt.chunkRows, 1);
+    const std::size_t chunkBlocks = (chunkRows + BLOCK_ROWS - 1) / BLOCK_ROWS;
+
+    std::vector<std::unique_ptr<Chunk>> pool;
+    ChunkQueue freeQ, splitQ, doneQ;
+    for (int i = 0; i < POOL_CHUNKS; ++i) {
+        auto c = std::make_unique<Chunk>();
+        c->lines.resize(chunkRows);
+        c->blocks.resize(chunkBlocks);
+        c->out.resize(chunkBlocks * BLOCK_ROWS * MAX_ROW_BYTES);
+        freeQ.push(c.get());
+        pool.push_back(std::move(c));
+    }
+
+    auto abortAll = [&]{ freeQ.close(); splitQ.close(); doneQ.close(); };
+
+    // Стадия 1: нарезка отображённого буфера на строки
+    std::thread splitter([&]{
+        const char *p = data;
+        const char *end = data + size;
+        if (size > 0 && opt.inFormat == Format::Csv && opt.skipHeader) {
+            const void *nl = std::memchr(p, '\n', size);
+            p = nl ? static_cast<const char*>(nl) + 1 : end;
+        }
+        while (p < end) {
+            Chunk *c = nullptr;
+            if (!freeQ.pop(c)) return;
+            c->count = 0;
+            while (p < end && c->count < chunkRows) {
+                const void *nl = std::memchr(p, '\n', std::size_t(end - p));
+                const char *eol = nl ? static_cast<const char*>(nl) : end;
+                const char *lineEnd = eol;
+                if (lineEnd > p && lineEnd[-1] == '\r') --lineEnd;
+                if (lineEnd > p) c->lines[c->count++] = { p, lineEnd };
+                p = nl ? eol + 1 : end;
+            }
+            c->inEnd = std::size_t(p - data);
+            if (!splitQ.push(c)) return;
+        }
+        splitQ.close();
+    });
+
+    // Стадия 3: запись блоков по порядку и прогресс
+    std::thread writer([&]{
+        auto fail = [&](const char *error, bool cancelled) {
+            st.ok = false;
+            st.cancelled = cancelled;
+            st.error = QString::fromLatin1(error);
+            abortAll();
+        };
+        if (opt.outFormat == Format::Csv) {
+            static const char header[] = "hex,r,g,b,h,s,v,X,Y,Z,L,A,B,oog\n";
+            if (!sink(header, sizeof(header) - 1)) return fail("write failed", false);
+            st.outBytes += sizeof(header) - 1;
+        }
+        Chunk *c = nullptr;
+        while (doneQ.pop(c)) {
+            const std::size_t blocks = (c->count + BLOCK_ROWS - 1) / BLOCK_ROWS;
+            for (std::size_t k = 0; k < blocks; ++k) {
+                const Block &b = c->blocks[k];
+                st.rows += b.rows;
+                st.badRows += b.bad;
+                st.outOfGamut += b.oog;
+                st.outBytes += b.bytes;
+                if (b.bytes && !sink(c->out.data() + k * BLOCK_ROWS * MAX_ROW_BYTES, b.bytes))
+                    return fail("write failed", false);
+            }
+            if (opt.progress && !opt.progress(c->inEnd, size))
+                return fail("cancelled", true);
+            freeQ.push(c);
+        }
+    });
+
+    // Стадия 2 (текущий поток + ThreadPool): разбор, конвертация и форматирование
+    // блоков чанка параллельно; порядок вывода задаёт очередь чанков
+    Chunk *c = nullptr;
+    while (splitQ.pop(c)) {
+        ThreadPool::instance().parallelFor((c->count + BLOCK_ROWS - 1) / BLOCK_ROWS, 1,
+            [&](std::size_t b, std::size_t e) {
+                for (std::size_t k = b; k < e; ++k) processBlock(*c, k, opt);
+            });
+        if (!doneQ.push(c)) break;
+    }
+    doneQ.close();
+
+    splitter.join();
+    writer.join();
+    st.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return st;
+}
+
+Stats convertFile(const QString &inPath, const QString &outPath, const Options &opt)
+{
+    Stats st;
+    QFile in(inPath);
+    if (!in.open(QIODevice::ReadOnly)) {
+        st.ok = false;
+        st.error = in.errorString();
+        return st;
+    }
+    // вывод пишется во временный файл и заменяет outPath только после успеха;
+    // при отмене или ошибке QSaveFile удаляет недописанный файл
+    QSaveFile out(outPath);
+    if (!out.open(QIODevice::WriteOnly)) {
+        st.ok = false;
+        st.error = out.errorString();
+        return st;
+    }
+    const Sink sink = [&](const char *d, std::size_t n){ return out.write(d, qint64(n)) == qint64(n); };
+
+    const qint64 size = in.size();
+    uchar *mapped = size > 0 ? in.map(0, size) : nullptr;
+    if (size > 0 && !mapped) {
+        st.ok = false;
+        st.error = in.errorString();
+        return st;
+    }
+
+    st = convertBuffer(reinterpret_cast<const char*>(mapped), std::size_t(size), opt, sink);
+    if (mapped) in.unmap(mapped);
+    if (st.ok && !out.commit()) {
+        st.ok = false;
+        st.error = out.errorString();
+    }
+    return st;
+}
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "ColorModels.h"
+
+#include <QString>
+#include <cstddef>
+#include <functional>
+
+// Пакетная конвертация таблиц цветов (CSV / JSON-lines).
+//
+// Входной файл отображается в память, строки разбираются через
+// std::from_chars без аллокаций на строку. Конвейер из трёх стадий обменивается
+// переиспользуемыми чанками фиксированного размера: нарезка на строки (поток),
+// разбор + конвертация + форматирование блоков чанка в ThreadPool, запись
+// по порядку чанков (поток). Числа выводятся с фиксированной точностью.
+//
+// Каждая выходная строка содержит цвет во всех моделях:
+//   hex,r,g,b,h,s,v,X,Y,Z,L,A,B,oog
+// h — в градусах, s и v — в долях 0..1 (как в Color::HSV),
+// oog — цвет был обрезан до sRGB (Color::ConvertFlags::outOfGamut).
+namespace ColorTable {
+
+enum class Format { Csv, JsonLines };
+
+// В какой модели задан исходный цвет строки.
+// CSV: hex — одна колонка, остальные — три подряд начиная с Options::column.
+// JSON-lines: ключи "hex" | "r","g","b" | "h","s","v" | "X","Y","Z" | "L","A","B".
+enum class Source { Hex, RGB, HSV, XYZ, Lab };
+
+struct Options {
+    Format inFormat  = Format::Csv;
+    Format outFormat = Format::Csv;
+    Source source    = Source::Hex;
+    int column = 0;              // CSV: индекс первой колонки исходного цвета
+    bool skipHeader = true;      // CSV: первая строка входа — заголовок
+    std::size_t chunkRows = 8192; // строк в одном чанке конвейера
+
+    // Прогресс по входным байтам после записи каждого чанка (из потока записи);
+    // вернуть false, чтобы отменить конвертацию
+    std::function<bool(std::size_t done, std::size_t total)> progress;
+};
+
+struct Stats {
+    std::size_t rows = 0;        // записано строк
+    std::size_t badRows = 0;     // строк, которые не удалось разобрать (пропущены)
+    std::size_t outOfGamut = 0;  // строк с обрезанным цветом
+    std::size_t inBytes = 0;
+    std::size_t outBytes = 0;
+    double seconds = 0.0;
+    bool ok = true;
+    bool cancelled = false;
+    QString error;
+
+    // Ориентир: около 2–3 млн строк/с на ядро для hex CSV (порядка 20 МБ/с входа),
+    // растёт с числом ядер; сотен МБ/с на коротких строках не достигает
+    double rowsPerSecond() const { return seconds > 0.0 ? rows / seconds : 0.0; }
+    double megabytesPerSecond() const { return seconds > 0.0 ? inBytes / seconds / (1024.0 * 1024.0) : 0.0; }
+};
+
+// Приёмник готового вывода; вызывается из потока записи по порядку.
+// Вернуть false, чтобы прервать конвейер.
+using Sink = std::function<bool(const char *data, std::size_t size)>;
+
+// Конвертировать буфер в памяти (например, отображённый файл).
+Stats convertBuffer(const char *data, std::size_t size, const Options &opt, const Sink &sink);
+
+// Отобразить inPath в память, сконвертировать и записать результат в outPath.
+// outPath заменяется только при успехе; при отмене или ошибке остаётся прежним.
+Stats convertFile(const QString &inPath, const QString &outPath, const Options &opt);
+
+}
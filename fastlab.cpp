@@ -0,0 +1,21 @@
+#include "fastlab.h"
+
+namespace FastLab {
+
+const Tables &tables() {
+    static const Tables t = [] {
+        Tables lt{};
+        const double white[3] = { Color::Xn, Color::Yn, Color::Zn };
+        for (int v = 0; v < 256; ++v) {
+            const double lin = Color::srgb8_to_linear(v);
+            for (int c = 0; c < 3; ++c)
+                for (int k = 0; k < 3; ++k)
+                    lt.xyz[c][k][v] = float(100.0 * Color::M_RGB_TO_XYZ[k][c] * lin / white[k]);
+        }
+        for (int i = 0; i <= F_STEPS; ++i) lt.f[i] = float(Color::f_lab(double(i) / F_STEPS));
+        return lt;
+    }();
+    return t;
+}
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "ColorModels.h"
+
+#include <algorithm>
+
+// Быстрый перевод 8-битного sRGB в Lab и HSV (float) для потоковой обработки.
+//
+// Таблицы: вклад каждого канала в X/Xn, Y/Yn, Z/Zn и f_lab(t) на сетке
+// с линейной интерполяцией (ошибка L порядка 1e-4). Вместо трёх cbrt и pow
+// на пиксель — девять выборок и три интерполяции.
+namespace FastLab {
+
+constexpr int F_STEPS = 8192;   // сетка t в 0..1
+
+struct Tables {
+    float xyz[3][3][256];        // [канал r/g/b][X/Y/Z][значение]
+    float f[F_STEPS + 1];
+};
+
+// Строятся при первом обращении, дальше только чтение из любых потоков
+const Tables &tables();
+
+inline float fLab(const Tables &t, float v) {
+    const float pos = std::max(0.f, v) * F_STEPS;
+    const int i = std::min(int(pos), F_STEPS - 1);
+    const float frac = pos - float(i);
+    return t.f[i] + (t.f[i + 1] - t.f[i]) * frac;
+}
+
+// lab[0..2] = L, a, b
+inline void rgbToLab(const Tables &t, int r, int g, int b, float *lab) {
+    const float xr = t.xyz[0][0][r] + t.xyz[1][0][g] + t.xyz[2][0][b];
+    const float yr = t.xyz[0][1][r] + t.xyz[1][1][g] + t.xyz[2][1][b];
+    const float zr = t.xyz[0][2][r] + t.xyz[1][2][g] + t.xyz[2][2][b];
+    const float fx = fLab(t, xr), fy = fLab(t, yr), fz = fLab(t, zr);
+    lab[0] = 116.f * fy - 16.f;
+    lab[1] = 500.f * (fx - fy);
+    lab[2] = 200.f * (fy - fz);
+}
+
+// hsv[0..2] = h (градусы), s, v (0..1); на целых каналах, совпадает с Color::RGB_to_HSV
+inline void rgbToHSV(int r, int g, int b, float *hsv) {
+    const int cmax = std::max({ r, g, b });
+    const int cmin = std::min({ r, g, b });
+    const int delta = cmax - cmin;
+    float h = 0.f;
+    if (delta > 0) {
+        const float inv = 60.f / float(delta);
+        if (cmax == r)      h = float(g - b) * inv;
+        else if (cmax == g) h = float(b - r) * inv + 120.f;
+        else                h = float(r - g) * inv + 240.f;
+        if (h < 0.f) h += 360.f;
+    }
+    hsv[0] = h;
+    hsv[1] = cmax > 0 ? float(delta) / float(cmax) : 0.f;
+    hsv[2] = float(cmax) * (1.f / 255.f);
+}
+
+}
@@ -0,0 +1,72 @@
+#include "gradient.h"
+#include "threadpool.h"
+
+#include <algorithm>
+
+namespace Gradient {
+
+namespace {
+
+Color::Lab lerpLab(const Color::Lab &a, const Color::Lab &b, double k) {
+    return { a.L + (b.L - a.L) * k, a.a + (b.a - a.a) * k, a.b + (b.b - a.b) * k };
+}
+
+// LCh: L и C линейно, тон — по кратчайшей дуге
+Color::Lab lerpLCh(const Color::Lab &a, const Color::Lab &b, double k) {
+    Color::LCh p = Color::Lab_to_LCh(a);
+    Color::LCh q = Color::Lab_to_LCh(b);
+    // у ахроматического цвета тон не определён — берём тон второго
+    if (p.C < 1e-9) p.h = q.h;
+    if (q.C < 1e-9) q.h = p.h;
+    double dh = q.h - p.h;
+    if (dh > 180.0) dh -= 360.0;
+    if (dh < -180.0) dh += 360.0;
+    return Color::LCh_to_Lab({ p.L + (q.L - p.L) * k, p.C + (q.C - p.C) * k, p.h + dh * k });
+}
+
+} // namespace
+
+Color::Lab sample(const Stop *stops, std::size_t count, double t, Space space) {
+    if (count == 0) return {};
+    if (count == 1 || t <= stops[0].pos) return stops[0].color;
+    if (t >= stops[count - 1].pos) return stops[count - 1].color;
+
+    // первый опорный цвет правее t
+    const Stop *hi = std::upper_bound(stops, stops + count, t,
+                                      [](double v, const Stop &s) { return v < s.pos; });
+    const Stop *lo = hi - 1;
+    const double span = hi->pos - lo->pos;
+    const double k = span > 1e-12 ? (t - lo->pos) / span : 0.0;
+    return space == Space::LCh ? lerpLCh(lo->color, hi->color, k)
+                               : lerpLab(lo->color, hi->color, k);
+}
+
+void generateRange(const Stop *stops, std::size_t count, int steps, Space space,
+                   int first, int last, Swatch *out) {
+    first = std::max(first, 0);
+    last = std::min(last, steps);
+    for (int i = first; i < last; ++i) {
+        const double t = steps > 1 ? double(i) / (steps - 1) : 0.0;
+        Swatch &s = out[i];
+        s.lab = sample(stops, count, t, space);
+        auto conv = Color::XYZ_to_RGB(Color::Lab_to_XYZ(s.lab));
+        s.rgb = conv.first;
+        s.outOfGamut = conv.second.outOfGamut;
+    }
+}
+
+std::vector<Swatch> generate(const Ramp &ramp) {
+    std::vector<Swatch> out(std::size_t(std::max(ramp.steps, 0)));
+    generateRange(ramp.stops.data(), ramp.stops.size(), ramp.steps, ramp.space, 0, ramp.steps, out.data());
+    return out;
+}
+
+std::vector<std::vector<Swatch>> generateBatch(const std::vector<Ramp> &ramps) {
+    std::vector<std::vector<Swatch>> out(ramps.size());
+    ThreadPool::instance().parallelFor(ramps.size(), 16, [&](std::size_t b, std::size_t e) {
+        for (std::size_t i = b; i < e; ++i) out[i] = generate(ramps[i]);
+    });
+    return out;
+}
+
+}
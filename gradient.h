@@ -0,0 +1,45 @@
+#pragma once
+#include "ColorModels.h"
+
+#include <cstddef>
+#include <vector>
+
+// Градиенты и палитры с интерполяцией в Lab или LCh.
+//
+// Шаг i из N берётся в точке t = i / (N - 1) между соседними опорными
+// цветами и переводится в sRGB через Lab_to_XYZ / XYZ_to_RGB; флаг
+// ConvertFlags::outOfGamut сохраняется для каждого шага.
+namespace Gradient {
+
+enum class Space { Lab, LCh };
+
+struct Stop {
+    double pos = 0.0;      // 0..1, опорные цвета упорядочены по pos
+    Color::Lab color;
+};
+
+struct Swatch {
+    Color::Lab lab;
+    Color::RGB rgb;
+    bool outOfGamut = false;
+};
+
+struct Ramp {
+    std::vector<Stop> stops;
+    int steps = 2;
+    Space space = Space::Lab;
+};
+
+// Цвет градиента в точке t (0..1)
+Color::Lab sample(const Stop *stops, std::size_t count, double t, Space space);
+
+// Шаги [first, last) градиента из steps шагов; out указывает на шаг 0
+void generateRange(const Stop *stops, std::size_t count, int steps, Space space,
+                   int first, int last, Swatch *out);
+
+std::vector<Swatch> generate(const Ramp &ramp);
+
+// Много градиентов сразу; распределяются по ThreadPool
+std::vector<std::vector<Swatch>> generateBatch(const std::vector<Ramp> &ramps);
+
+}
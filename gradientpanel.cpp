@@ -0,0 +1,225 @@
+#include "gradientpanel.h"
+
+#include <QComboBox>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPainterPath>
+#include <QSpinBox>
+#include <QVBoxLayout>
+
+#include <algorithm>
+#include <cmath>
+
+static constexpr int STRIP_H  = 40;
+static constexpr int HANDLE_H = 14;
+static constexpr int HANDLE_HALF_W = 6;   // полуширина треугольника опорной точки
+
+GradientPanel::GradientPanel(QWidget *parent)
+    : QWidget(parent)
+{
+    m_stops = { { 0.0, { 0.0, 0.0, 0.0 } }, { 1.0, { 100.0, 0.0, 0.0 } } };
+
+    m_steps = new QSpinBox(this);
+    m_steps->setRange(2, 256);
+    m_steps->setValue(9);
+    m_spaceBox = new QComboBox(this);
+    m_spaceBox->addItem(tr("LAB"));
+    m_spaceBox->addItem(tr("LCh"));
+
+    auto *controls = new QHBoxLayout;
+    controls->setContentsMargins(0, 0, 0, 0);
+    controls->addWidget(new QLabel(tr("Steps:"), this));
+    controls->addWidget(m_steps);
+    controls->addWidget(m_spaceBox);
+    controls->addStretch(1);
+
+    auto *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addLayout(controls);
+    layout->addSpacing(STRIP_H + HANDLE_H + 6);
+
+    setMinimumHeight(controls->sizeHint().height() + STRIP_H + HANDLE_H + 6);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+
+    auto onSpace = [this](int i){
+        m_space = i == 1 ? Gradient::Space::LCh : Gradient::Space::Lab;
+        rebuildAll();
+    };
+#if QT_VERSION >= QT_VERSION_CHECK(5,7,0)
+    connect(m_steps, qOverload<int>(&QSpinBox::valueChanged), this, [this]{ rebuildAll(); });
+    connect(m_spaceBox, qOverload<int>(&QComboBox::currentIndexChanged), this, onSpace);
+#else
+    connect(m_steps, SIGNAL(valueChanged(int)), this, [this]{ rebuildAll(); });
+    connect(m_spaceBox, SIGNAL(currentIndexChanged(int)), this, onSpace);
+#endif
+
+    rebuildAll();
+}
+
+void GradientPanel::setCurrentColor(const Color::Lab &lab)
+{
+    m_current = lab;
+    if (m_selected < 0 || m_selected >= int(m_stops.size())) return;
+    const Color::Lab &old = m_stops[m_selected].color;
+    if (old.L == lab.L && old.a == lab.a && old.b == lab.b) return;
+
+    m_stops[m_selected].color = lab;
+    const double left  = m_selected > 0 ? m_stops[m_selected - 1].pos : 0.0;
+    const double right = m_selected + 1 < int(m_stops.size()) ? m_stops[m_selected + 1].pos : 1.0;
+    rebuildBetween(left, right);
+}
+
+// ===== геометрия ===========================================================
+
+QRect GradientPanel::stripRect() const
+{
+    return QRect(0, height() - STRIP_H - HANDLE_H - 2, width(), STRIP_H);
+}
+
+QRect GradientPanel::handleRect() const
+{
+    return QRect(0, height() - HANDLE_H, width(), HANDLE_H);
+}
+
+double GradientPanel::posAt(int x) const
+{
+    return std::clamp(double(x) / std::max(1, width() - 1), 0.0, 1.0);
+}
+
+int GradientPanel::stopAt(const QPoint &p) const
+{
+    if (!handleRect().adjusted(0, -4, 0, 0).contains(p)) return -1;
+    int best = -1;
+    int bestDist = HANDLE_H;
+    for (int i = 0; i < int(m_stops.size()); ++i) {
+        const int d = std::abs(int(std::round(m_stops[i].pos * (width() - 1))) - p.x());
+        if (d < bestDist) { bestDist = d; best = i; }
+    }
+    return best;
+}
+
+// ===== пересчёт ============================================================
+
+void GradientPanel::rebuildAll()
+{
+    m_swatches.resize(std::size_t(m_steps->value()));
+    rebuildBetween(0.0, 1.0);
+}
+
+// Пересчитать только шаги, попадающие в [from, to]
+void GradientPanel::rebuildBetween(double from, double to)
+{
+    const int n = int(m_swatches.size());
+    if (n == 0) return;
+    const int first = std::max(0, int(std::floor(from * (n - 1))));
+    const int last  = std::min(n, int(std::ceil(to * (n - 1))) + 1);
+    Gradient::generateRange(m_stops.data(), m_stops.size(), n, m_space, first, last, m_swatches.data());
+
+    const QRect strip = stripRect();
+    const int x0 = strip.left() + first * strip.width() / n;
+    const int x1 = strip.left() + last * strip.width() / n;
+    // треугольники опорных точек на краях диапазона выступают за шаги;
+    // +2 — обводка выделенной точки со сглаживанием
+    const int pad = HANDLE_HALF_W + 2;
+    update(QRect(x0 - pad, strip.top() - 1, x1 - x0 + 1 + 2 * pad, height() - strip.top() + 1));
+}
+
+// ===== отрисовка и мышь ====================================================
+
+void GradientPanel::paintEvent(QPaintEvent *)
+{
+    QPainter p(this);
+    const QRect strip = stripRect();
+    const int n = int(m_swatches.size());
+
+    for (int i = 0; i < n; ++i) {
+        const int x0 = strip.left() + i * strip.width() / n;
+        const int x1 = strip.left() + (i + 1) * strip.width() / n;
+        const auto &s = m_swatches[i];
+        p.fillRect(QRect(x0, strip.top(), x1 - x0, strip.height()), QColor(s.rgb.r, s.rgb.g, s.rgb.b));
+        if (s.outOfGamut) {
+            // метка шага, обрезанного до sRGB
+            QPainterPath mark;
+            mark.moveTo(x0, strip.top());
+            mark.lineTo(x0 + 8, strip.top());
+            mark.lineTo(x0, strip.top() + 8);
+            mark.closeSubpath();
+            p.fillPath(mark, QColor("#D03030"));
+        }
+    }
+    p.setPen(QColor("#C9CCD6"));
+    p.drawRect(strip.adjusted(0, 0, -1, -1));
+
+    const QRect handles = handleRect();
+    p.setRenderHint(QPainter::Antialiasing);
+    for (int i = 0; i < int(m_stops.size()); ++i) {
+        const double x = m_stops[i].pos * (width() - 1);
+        QPainterPath tri;
+        tri.moveTo(x, handles.top());
+        tri.lineTo(x - HANDLE_HALF_W, handles.bottom());
+        tri.lineTo(x + HANDLE_HALF_W, handles.bottom());
+        tri.closeSubpath();
+        auto conv = Color::XYZ_to_RGB(Color::Lab_to_XYZ(m_stops[i].color));
+        p.fillPath(tri, QColor(conv.first.r, conv.first.g, conv.first.b));
+        p.setPen(QPen(QColor(i == m_selected ? "#04070b" : "#888888"), i == m_selected ? 2 : 1));
+        p.drawPath(tri);
+    }
+}
+
+void GradientPanel::mousePressEvent(QMouseEvent *event)
+{
+    const int i = stopAt(event->pos());
+    if (i < 0) return;
+
+    if (event->button() == Qt::RightButton) {
+        if (m_stops.size() <= 2) return;
+        const double left  = i > 0 ? m_stops[i - 1].pos : 0.0;
+        const double right = i + 1 < int(m_stops.size()) ? m_stops[i + 1].pos : 1.0;
+        m_stops.erase(m_stops.begin() + i);
+        // выделение остаётся на той же опорной точке; удалённую заменяет соседняя
+        if (m_selected > i) --m_selected;
+        else if (m_selected == i) m_selected = std::min(i, int(m_stops.size()) - 1);
+        rebuildBetween(left, right);
+        update();
+        return;
+    }
+
+    m_selected = i;
+    m_dragging = i;
+    update();
+    emit stopSelected(m_stops[i].color);
+}
+
+void GradientPanel::mouseMoveEvent(QMouseEvent *event)
+{
+    if (m_dragging < 0) return;
+    const int i = m_dragging;
+    // опорный цвет не обгоняет соседей, поэтому порядок сохраняется
+    const double left  = i > 0 ? m_stops[i - 1].pos : 0.0;
+    const double right = i + 1 < int(m_stops.size()) ? m_stops[i + 1].pos : 1.0;
+    const double pos = std::clamp(posAt(event->pos().x()), left, right);
+    if (pos == m_stops[i].pos) return;
+    m_stops[i].pos = pos;
+    rebuildBetween(left, right);
+}
+
+void GradientPanel::mouseReleaseEvent(QMouseEvent *)
+{
+    m_dragging = -1;
+}
+
+void GradientPanel::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    if (!stripRect().contains(event->pos())) return;
+    const double pos = posAt(event->pos().x());
+    auto it = std::upper_bound(m_stops.begin(), m_stops.end(), pos,
+                               [](double v, const Gradient::Stop &s) { return v < s.pos; });
+    it = m_stops.insert(it, { pos, m_current });
+    m_selected = int(it - m_stops.begin());
+    const double left  = m_selected > 0 ? m_stops[m_selected - 1].pos : 0.0;
+    const double right = m_selected + 1 < int(m_stops.size()) ? m_stops[m_selected + 1].pos : 1.0;
+    rebuildBetween(left, right);
+    update();
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "gradient.h"
+
+#include <QWidget>
+#include <vector>
+
+class QSpinBox;
+class QComboBox;
+
+// Панель градиента рядом с превью: N шагов между опорными цветами.
+// Опорные цвета можно перетаскивать (пересчитываются только шаги между
+// соседями перетаскиваемого), двойной щелчок добавляет опорный цвет
+// текущего цвета, правый щелчок удаляет. Шаги вне sRGB помечаются.
+class GradientPanel : public QWidget {
+    Q_OBJECT
+public:
+    explicit GradientPanel(QWidget *parent = nullptr);
+
+    // Текущий цвет редакторов: задаёт цвет выбранного опорного цвета
+    void setCurrentColor(const Color::Lab &lab);
+
+signals:
+    // Выбран опорный цвет — редакторы показывают его цвет
+    void stopSelected(const Color::Lab &lab);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private:
+    QRect stripRect() const;
+    QRect handleRect() const;
+    int stopAt(const QPoint &p) const;
+    double posAt(int x) const;
+    void rebuildAll();
+    void rebuildBetween(double from, double to);
+
+    std::vector<Gradient::Stop> m_stops;
+    std::vector<Gradient::Swatch> m_swatches;
+    Gradient::Space m_space = Gradient::Space::Lab;
+    Color::Lab m_current;
+    int m_selected = 0;
+    int m_dragging = -1;
+
+    QSpinBox *m_steps = nullptr;
+    QComboBox *m_spaceBox = nullptr;
+};
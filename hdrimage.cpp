@@ -0,0 +1,122 @@
+#include "hdrimage.h"
+
+#include <algorithm>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HDRIMAGE_SSE 1
+#endif
+
+namespace HdrImage {
+
+namespace {
+
+// Строка линейного RGB(A) -> XYZ (0..100), 3 float на пиксель.
+// dst должен иметь запас в 1 float после width*3 (запись по 4 float).
+void linearRowToXYZ(const float *src, int channels, int width, bool clamp, float *dst)
+{
+    const auto &M = Color::M_RGB_TO_XYZ;
+    int i = 0;
+#ifdef HDRIMAGE_SSE
+    const __m128 c0 = _mm_setr_ps(float(100.0 * M[0][0]), float(100.0 * M[1][0]), float(100.0 * M[2][0]), 0.f);
+    const __m128 c1 = _mm_setr_ps(float(100.0 * M[0][1]), float(100.0 * M[1][1]), float(100.0 * M[2][1]), 0.f);
+    const __m128 c2 = _mm_setr_ps(float(100.0 * M[0][2]), float(100.0 * M[1][2]), float(100.0 * M[2][2]), 0.f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.f);
+    // для RGB (3 канала) последний пиксель читать по 4 float нельзя
+    const int simdEnd = channels == 4 ? width : width - 1;
+    for (; i < simdEnd; ++i) {
+        __m128 p = _mm_loadu_ps(src + std::size_t(i) * channels);
+        if (clamp) p = _mm_min_ps(_mm_max_ps(p, zero), one);
+        __m128 r = _mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0));
+        __m128 g = _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1));
+        __m128 b = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2));
+        __m128 xyz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, r), _mm_mul_ps(c1, g)), _mm_mul_ps(c2, b));
+        _mm_storeu_ps(dst + std::size_t(i) * 3, xyz);
+    }
+#endif
+    for (; i < width; ++i) {
+        const float *p = src + std::size_t(i) * channels;
+        Color::LinearRGB c{ p[0], p[1], p[2] };
+        if (clamp) c = { Color::clamp01(c.r), Color::clamp01(c.g), Color::clamp01(c.b) };
+        Color::XYZ xyz = Color::LinearRGB_to_XYZ(c);
+        float *d = dst + std::size_t(i) * 3;
+        d[0] = float(xyz.X); d[1] = float(xyz.Y); d[2] = float(xyz.Z);
+    }
+}
+
+void xyzRowToLab(float *row, int width)
+{
+    for (int i = 0; i < width; ++i) {
+        float *d = row + std::size_t(i) * 3;
+        Color::Lab lab = Color::XYZ_to_Lab({ d[0], d[1], d[2] });
+        d[0] = float(lab.L); d[1] = float(lab.a); d[2] = float(lab.b);
+    }
+}
+
+// Буфер одной полосы результата (+1 float запаса для записи по 4).
+struct TileBuffer {
+    std::vector<float> data;
+    std::size_t stride = 0;
+
+    TileBuffer(int width, int rows)
+        : data(std::size_t(width) * 3 * std::size_t(rows) + 1), stride(std::size_t(width) * 3) {}
+    float *row(int r) { return data.data() + stride * std::size_t(r); }
+};
+
+} // namespace
+
+void processLinearFloat(const float *pixels, int width, int height, std::size_t stride,
+                        int channels, const Options &opt, const TileSink &sink)
+{
+    if (!pixels || width <= 0 || height <= 0 || (channels != 3 && channels != 4)) return;
+    const int tileRows = std::max(1, opt.tileRows);
+    TileBuffer buf(width, std::min(tileRows, height));
+
+    for (int y = 0; y < height; y += tileRows) {
+        const int rows = std::min(tileRows, height - y);
+        for (int r = 0; r < rows; ++r) {
+            float *dst = buf.row(r);
+            linearRowToXYZ(pixels + stride * std::size_t(y + r), channels, width, opt.clampToGamut, dst);
+            if (opt.target == Target::Lab) xyzRowToLab(dst, width);
+        }
+        sink({ y, width, rows, buf.data.data(), buf.stride });
+    }
+}
+
+void processRGBA64(const QImage &image, const Options &opt, const TileSink &sink)
+{
+    if (image.isNull()) return;
+    const int width = image.width();
+    const int height = image.height();
+    const int tileRows = std::max(1, opt.tileRows);
+    const bool direct = image.format() == QImage::Format_RGBA64
+                     || image.format() == QImage::Format_RGBX64;
+
+    TileBuffer buf(width, std::min(tileRows, height));
+    std::vector<float> linear(std::size_t(width) * 4);
+
+    for (int y = 0; y < height; y += tileRows) {
+        const int rows = std::min(tileRows, height - y);
+        // прочие форматы переводим в RGBA64 только в пределах полосы
+        const QImage strip = direct ? QImage()
+                                    : image.copy(0, y, width, rows).convertToFormat(QImage::Format_RGBA64);
+        for (int r = 0; r < rows; ++r) {
+            const auto *src = reinterpret_cast<const quint16*>(
+                direct ? image.constScanLine(y + r) : strip.constScanLine(r));
+            for (int x = 0; x < width; ++x) {
+                linear[4 * x + 0] = Color::srgb16_to_linear(src[4 * x + 0]);
+                linear[4 * x + 1] = Color::srgb16_to_linear(src[4 * x + 1]);
+                linear[4 * x + 2] = Color::srgb16_to_linear(src[4 * x + 2]);
+                linear[4 * x + 3] = 1.f;
+            }
+            float *dst = buf.row(r);
+            linearRowToXYZ(linear.data(), 4, width, opt.clampToGamut, dst);
+            if (opt.target == Target::Lab) xyzRowToLab(dst, width);
+        }
+        sink({ y, width, rows, buf.data.data(), buf.stride });
+    }
+}
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "ColorModels.h"
+
+#include <QImage>
+#include <cstddef>
+#include <functional>
+
+// Конвертация 16-битных (QImage::Format_RGBA64) и float32 линейных изображений
+// в XYZ / Lab без квантования до 8 бит.
+//
+// Изображение обрабатывается полосами по tileRows строк: в памяти держится
+// только одна полоса результата, готовые полосы отдаются в TileSink.
+// Матричный шаг для float-данных выполняется на SSE.
+namespace HdrImage {
+
+enum class Target { XYZ, Lab };
+
+struct Options {
+    Target target = Target::Lab;
+    bool clampToGamut = true;   // false — не обрезать линейный RGB до 0..1 (HDR > 1.0)
+    int tileRows = 64;
+};
+
+// Полоса результата: rows строк по width пикселей, 3 float на пиксель
+// (X,Y,Z в шкале 0..100 или L,a,b). stride — число float в строке.
+struct Tile {
+    int y = 0;
+    int width = 0;
+    int rows = 0;
+    const float *data = nullptr;
+    std::size_t stride = 0;
+};
+
+using TileSink = std::function<void(const Tile &tile)>;
+
+// 16-битное sRGB-изображение; другие форматы переводятся в RGBA64 по полосам.
+void processRGBA64(const QImage &image, const Options &opt, const TileSink &sink);
+
+// Линейный float32 RGB (channels = 3) или RGBA (channels = 4),
+// stride — число float в строке исходного буфера.
+void processLinearFloat(const float *pixels, int width, int height, std::size_t stride,
+                        int channels, const Options &opt, const TileSink &sink);
+
+}
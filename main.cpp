@@ -1,18 +1,73 @@
 #include "mainwindow.h"
+#include "videopipeline.h"
+#include "appstyle.h"
 
 #include <QApplication>
-#include <QApplication>
-#include <QPalette>
+#include <QElapsedTimer>
+#include <QEvent>
 #include <QFont>
+#include <QTimer>
+#include <QtGlobal>
+#include <cstring>
+
+// Отчёт о времени запуска: создание QApplication, построение окна и первая
+// отрисовка. Бюджет в мс можно задать в COLORCONVERTER_STARTUP_BUDGET_MS —
+// при превышении выводится предупреждение.
+class StartupReport : public QObject {
+public:
+    explicit StartupReport(const QElapsedTimer &clock) : m_clock(clock) {}
+
+    qint64 appMs = 0;
+    qint64 windowMs = 0;
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *event) override {
+        if (event->type() == QEvent::Paint && !m_seen) {
+            m_seen = true;
+            // первая отрисовка завершается вместе с текущим проходом цикла событий
+            QTimer::singleShot(0, this, [this]{ report(); });
+            qApp->removeEventFilter(this);
+        }
+        return QObject::eventFilter(obj, event);
+    }
+
+private:
+    void report() {
+        const qint64 paintMs = m_clock.elapsed();
+        qInfo("startup: QApplication %lld ms, window built %lld ms, first paint %lld ms",
+              appMs, windowMs, paintMs);
+        bool ok = false;
+        const qint64 budget = qEnvironmentVariableIntValue("COLORCONVERTER_STARTUP_BUDGET_MS", &ok);
+        if (ok && paintMs > budget)
+            qWarning("startup: first paint %lld ms exceeds budget %lld ms", paintMs, budget);
+    }
+
+    const QElapsedTimer &m_clock;
+    bool m_seen = false;
+};
 
 int main(int argc, char *argv[])
 {
+    // консольный режим: обработка видео со stdin без GUI
+    if (argc > 1 && std::strcmp(argv[1], "--video") == 0)
+        return VideoPipeline::runFromArgs(argc, argv);
+
+    QElapsedTimer clock;
+    clock.start();
+    StartupReport startup(clock);
+
     QApplication app(argc, argv);
-    QFont appFont("Segoe Print", 14);
-    appFont. setBold(10);
+    startup.appMs = clock.elapsed();
+
+    QFont appFont = AppStyle::displayFont(14);
+    appFont.setBold(true);
     app.setFont(appFont);
+    // стиль задаётся до создания окна, чтобы виджеты полировались один раз
+    AppStyle::applyAppStyle(&app);
+    app.installEventFilter(&startup);
 
     MainWindow w;
+    startup.windowMs = clock.elapsed();
     w.show();
     return app.exec();
 }
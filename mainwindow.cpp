@@ -1,6 +1,11 @@
 #include "mainwindow.h"
 #include "ColorModels.h"
-#include "AppStyle.h"
+#include "ColorGraph.h"
+#include "appstyle.h"
+#include "gradientpanel.h"
+#include "asyncjob.h"
+#include "colortable.h"
+#include "colorstats.h"
 
 #include <QSpinBox>
 #include <QDoubleSpinBox>
@@ -20,6 +25,15 @@
 #include <QStyleFactory>
 #include <QPalette>
 #include <QLabel>
+#include <QMenuBar>
+#include <QFileDialog>
+#include <QInputDialog>
+#include <QMessageBox>
+#include <QProgressBar>
+#include <QImage>
+
+#include <algorithm>
+#include <optional>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -70,7 +84,7 @@ MainWindow::MainWindow(QWidget *parent)
 
     // ===== HSV ===========================================================
     auto *hsvGroup = new QGroupBox(tr("HSV"), this);
-    QFont font("Segoe Print", 16, QFont::Black);
+    QFont font = AppStyle::displayFont(16, QFont::Black);
     hsvGroup->setFont(font);
 
     spinH = new QDoubleSpinBox(this);
@@ -229,8 +243,7 @@ MainWindow::MainWindow(QWidget *parent)
     connect(pickLabBtn, &QPushButton::clicked, this, [this]{
         QColor c = QColorDialog::getColor(Qt::white, this, tr("Color Picker"));
         if (!c.isValid()) return;
-        Color::XYZ xyz = Color::RGB_to_XYZ({c.red(),c.green(),c.blue()});
-        Color::Lab lab = Color::XYZ_to_Lab(xyz);
+        Color::Lab lab = Color::convert<Color::Lab>(Color::RGB{c.red(),c.green(),c.blue()});
         QSignalBlocker bl(spinL), ba(spina), bb(spinb);
         spinL->setValue(lab.L); spina->setValue(lab.a); spinb->setValue(lab.b);
         onLabChanged();
@@ -246,10 +259,21 @@ MainWindow::MainWindow(QWidget *parent)
 
     previewFrame->setAutoFillBackground(true);
 
+    // панель градиента строится при первом открытии, а не при запуске
+    auto *gradientBtn = new QPushButton(tr("Gradient"), this);
+    gradientBtn->setCheckable(true);
+    connect(gradientBtn, &QPushButton::toggled, this, [this](bool on){
+        if (on) ensureGradientPanel();
+        if (gradientPanel) gradientPanel->setVisible(on);
+        // превью уступает место панели только пока она открыта
+        previewFrame->setMinimumSize(300, on ? 430 : 550);
+    });
+
     QWidget *previewWrapper = new QWidget(this);
-    QVBoxLayout *pvLayout = new QVBoxLayout(previewWrapper);
-    pvLayout->addWidget(previewFrame, 0, Qt::AlignCenter);
-    pvLayout->setContentsMargins(10, 24, 10, 10);
+    previewLayout = new QVBoxLayout(previewWrapper);
+    previewLayout->addWidget(previewFrame, 0, Qt::AlignCenter);
+    previewLayout->addWidget(gradientBtn);
+    previewLayout->setContentsMargins(10, 24, 10, 10);
 
     unifySpinWidths({
         spinH, spinS, spinV,
@@ -283,19 +307,41 @@ MainWindow::MainWindow(QWidget *parent)
     grid->setColumnStretch(1, 1);
     central->setLayout(grid);
 
+    // ===== фоновые задачи ================================================
+    auto *fileMenu = menuBar()->addMenu(tr("File"));
+    fileMenu->addAction(tr("Convert color table..."), this, &MainWindow::onConvertTable);
+    fileMenu->addAction(tr("Image statistics..."), this, &MainWindow::onImageStats);
+
+    jobProgress = new QProgressBar(this);
+    jobProgress->setRange(0, 1000);
+    jobProgress->setMaximumWidth(200);
+    jobCancel = new QPushButton(tr("Cancel"), this);
+    statusBar()->addPermanentWidget(jobProgress);
+    statusBar()->addPermanentWidget(jobCancel);
+    jobProgress->hide();
+    jobCancel->hide();
+    connect(jobCancel, &QPushButton::clicked, this, [this]{
+        if (m_job) m_job->cancel();
+    });
+
     spinH->setValue(0.0);
     spinS->setValue(100.0);
     spinV->setValue(100.0);
     onHsvChanged();
-
-    AppStyle::applyAppStyle(this);
 }
 
 
 
 
 
-MainWindow::~MainWindow() = default;
+MainWindow::~MainWindow()
+{
+    // задача доставляет результат в это окно — дожидаемся только её
+    if (m_job) {
+        m_job->cancel();
+        m_job->wait();
+    }
+}
 
 void MainWindow::setHSVui(double H_deg, double S_pct, double V_pct) {
     QSignalBlocker bh(spinH), bs(spinS), bv(spinV);
@@ -329,6 +375,20 @@ void MainWindow::setLabui(double L, double a, double b) {
 
 // ===== ВСПОМОГАТЕЛЬНОЕ =====================================================
 
+void MainWindow::ensureGradientPanel()
+{
+    if (gradientPanel) return;
+
+    // выбранный опорный цвет следует за редакторами
+    gradientPanel = new GradientPanel(this);
+    gradientPanel->setCurrentColor({spinL->value(), spina->value(), spinb->value()});
+    connect(gradientPanel, &GradientPanel::stopSelected, this, [this](const Color::Lab &lab){
+        setLabui(lab.L, lab.a, lab.b);
+        onLabChanged();
+    });
+    previewLayout->addWidget(gradientPanel);
+}
+
 void MainWindow::updatePreview(const Color::RGB &rgb)
 {
     previewFrame->setStyleSheet(
@@ -359,6 +419,7 @@ void MainWindow::onXyzChanged() {
     else
         statusBar()->clearMessage();
 
+    if (gradientPanel) gradientPanel->setCurrentColor(lab);
     updatePreview(rgb);
     m_updating = false;
 }
@@ -383,6 +444,7 @@ void MainWindow::onLabChanged() {
     else
         statusBar()->clearMessage();
 
+    if (gradientPanel) gradientPanel->setCurrentColor(lab);
     updatePreview(rgb);
     m_updating = false;
 }
@@ -402,9 +464,148 @@ void MainWindow::onHsvChanged() {
 
     statusBar()->clearMessage();
 
+    if (gradientPanel) gradientPanel->setCurrentColor(lab);
     updatePreview(rgb);
     m_updating = false;
 }
 
+// ===== ФОНОВЫЕ ЗАДАЧИ ======================================================
+
+void MainWindow::beginJob(std::shared_ptr<Async::Job> job, const QString &title)
+{
+    m_job = std::move(job);
+    jobProgress->setValue(0);
+    jobProgress->show();
+    jobCancel->show();
+    statusBar()->showMessage(title);
+}
+
+void MainWindow::endJob()
+{
+    m_job.reset();
+    jobProgress->hide();
+    jobCancel->hide();
+}
 
+void MainWindow::onJobProgress(qint64 done, qint64 total)
+{
+    jobProgress->setValue(total > 0 ? int(done * 1000 / total) : 0);
+}
 
+void MainWindow::onConvertTable()
+{
+    if (m_job) return;
+
+    const QString in = QFileDialog::getOpenFileName(this, tr("Color table"), QString(),
+                                                    tr("Tables (*.csv *.jsonl *.json);;All files (*)"));
+    if (in.isEmpty()) return;
+    const QStringList sources{ "HEX", "RGB", "HSV", "XYZ", "LAB" };
+    bool ok = false;
+    const QString src = QInputDialog::getItem(this, tr("Color table"), tr("Input color model:"),
+                                              sources, 0, false, &ok);
+    if (!ok) return;
+    const QString out = QFileDialog::getSaveFileName(this, tr("Save converted table"), QString(),
+                                                     tr("CSV (*.csv);;JSON lines (*.jsonl)"));
+    if (out.isEmpty()) return;
+
+    auto formatOf = [](const QString &path){
+        return path.endsWith(".jsonl", Qt::CaseInsensitive) || path.endsWith(".json", Qt::CaseInsensitive)
+            ? ColorTable::Format::JsonLines : ColorTable::Format::Csv;
+    };
+    ColorTable::Options opt;
+    opt.inFormat = formatOf(in);
+    opt.outFormat = formatOf(out);
+    opt.source = ColorTable::Source(sources.indexOf(src));
+
+    auto job = Async::run(this,
+        [in, out, opt](Async::Job &job) {
+            ColorTable::Options o = opt;
+            o.progress = [&job](std::size_t done, std::size_t total) {
+                job.reportProgress(qint64(done), qint64(total));
+                return !job.isCancelled();
+            };
+            return ColorTable::convertFile(in, out, o);
+        },
+        [this](const ColorTable::Stats &st) {
+            endJob();
+            if (st.cancelled)
+                statusBar()->showMessage(tr("Table conversion cancelled."));
+            else if (!st.ok)
+                QMessageBox::warning(this, tr("Color table"), st.error);
+            else
+                statusBar()->showMessage(tr("%1 rows (%2 skipped, %3 out of gamut), %4 rows/s, %5 MB/s")
+                    .arg(st.rows).arg(st.badRows).arg(st.outOfGamut)
+                    .arg(qint64(st.rowsPerSecond())).arg(st.megabytesPerSecond(), 0, 'f', 1));
+        },
+        [this](qint64 done, qint64 total) { onJobProgress(done, total); });
+    beginJob(std::move(job), tr("Converting table..."));
+}
+
+void MainWindow::onImageStats()
+{
+    if (m_job) return;
+
+    const QString path = QFileDialog::getOpenFileName(this, tr("Image statistics"), QString(),
+                                                      tr("Images (*.png *.jpg *.jpeg *.bmp *.tif *.tiff);;All files (*)"));
+    if (path.isEmpty()) return;
+
+    // gamutChecked — формат может хранить цвета вне sRGB, долю есть смысл показывать
+    struct ImageStats {
+        ColorStats::Result stats;
+        bool gamutChecked = false;
+    };
+
+    auto job = Async::run(this,
+        [path](Async::Job &job) -> std::optional<ImageStats> {
+            if (job.isCancelled()) return std::nullopt;
+            const QImage image(path);
+            if (image.isNull() || job.isCancelled()) return std::nullopt;
+
+            // подаём изображение полосами, чтобы сообщать прогресс и проверять отмену;
+            // полоса — обёртка над строками исходника без копии, на все потоки пула
+            ColorStats::Accumulator acc;
+            const int w = image.width();
+            const int h = image.height();
+            const int strip = ColorStats::stripRows(w);
+            for (int y = 0; y < h; y += strip) {
+                if (job.isCancelled()) return std::nullopt;
+                const int rows = std::min(strip, h - y);
+                QImage part(image.constScanLine(y), w, rows, image.bytesPerLine(), image.format());
+                part.setColorTable(image.colorTable());
+                acc.addImage(part);
+                job.reportProgress(y + rows, h);
+            }
+            return ImageStats{ acc.result(), ColorStats::canBeOutOfGamut(image) };
+        },
+        [this, path](const std::optional<ImageStats> &res) {
+            const bool cancelled = m_job && m_job->isCancelled();
+            endJob();
+            if (!res) {
+                if (cancelled) statusBar()->showMessage(tr("Image statistics cancelled."));
+                else QMessageBox::warning(this, tr("Image statistics"), tr("Cannot read %1").arg(path));
+                return;
+            }
+            statusBar()->clearMessage();
+            const ColorStats::Result &r = res->stats;
+            int hue = 0;
+            for (int i = 1; i < ColorStats::HUE_BINS; ++i)
+                if (r.hueHist[i] > r.hueHist[hue]) hue = i;
+            QString text = tr("Pixels: %1\n"
+                              "Mean LAB: %2, %3, %4\n"
+                              "L percentiles 5/50/95: %5 / %6 / %7\n"
+                              "Mean saturation / value: %8 / %9\n"
+                              "Dominant hue: %10")
+                    .arg(r.pixels)
+                    .arg(r.mean.L, 0, 'f', 2).arg(r.mean.a, 0, 'f', 2).arg(r.mean.b, 0, 'f', 2)
+                    .arg(r.percentileL(5), 0, 'f', 1).arg(r.percentileL(50), 0, 'f', 1).arg(r.percentileL(95), 0, 'f', 1)
+                    .arg(r.meanSaturation * 100.0, 0, 'f', 1).arg(r.meanValue * 100.0, 0, 'f', 1)
+                    .arg(r.chromatic ? QString("%1°").arg(hue) : QString("—"));
+            // 8- и 16-битные форматы не выходят за sRGB, доля там всегда 0
+            if (res->gamutChecked)
+                text += tr("\nOut of sRGB gamut: %1%").arg(r.outOfGamutFraction() * 100.0, 0, 'f', 2);
+            QMessageBox::information(this, tr("Image statistics"), text);
+        },
+        [this](qint64 done, qint64 total) { onJobProgress(done, total); },
+        Async::Priority::Low);
+    beginJob(std::move(job), tr("Analyzing image..."));
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include <QMainWindow>
+#include <memory>
 
 class QSpinBox;
 class QDoubleSpinBox;
@@ -7,8 +8,12 @@ class QFrame;
 class QSlider;
 class QLineEdit;
 class QPushButton;
+class QVBoxLayout;
+class QProgressBar;
+class GradientPanel;
 
 namespace Color { struct RGB; }
+namespace Async { class Job; }
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -20,11 +25,17 @@ private slots:
     void onXyzChanged();
     void onLabChanged();
     void onHsvChanged();
+    void onConvertTable();
+    void onImageStats();
 
 private:
     // Вспомогательные методы
     void updatePreview(const Color::RGB &rgb);
     void updateFromRGB(const Color::RGB &rgb, bool showWarning);
+    void ensureGradientPanel();
+    void beginJob(std::shared_ptr<Async::Job> job, const QString &title);
+    void endJob();
+    void onJobProgress(qint64 done, qint64 total);
 
     // Флаг защиты от рекурсии
     bool m_updating = false;
@@ -54,6 +65,13 @@ private:
     QSlider *bbSlider = nullptr;
 
     QFrame *previewFrame = nullptr;
+    QVBoxLayout *previewLayout = nullptr;
+    GradientPanel *gradientPanel = nullptr;   // создаётся лениво
+
+    // Фоновая задача (таблица / статистика изображения)
+    std::shared_ptr<Async::Job> m_job;
+    QProgressBar *jobProgress = nullptr;
+    QPushButton *jobCancel = nullptr;
 
     static constexpr int SL_SCALE = 1000;
 
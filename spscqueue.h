@@ -0,0 +1,77 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+// Ограниченная lock-free очередь «один писатель — один читатель».
+// Capacity должна быть степенью двойки; элементы хранятся в кольцевом буфере
+// внутри объекта, push/pop не выделяют память. Блокирующие push/pop недолго
+// крутятся, а затем засыпают, чтобы простаивающая стадия не занимала ядро.
+template<class T, std::size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    bool tryPush(const T &v) {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == Capacity) return false;
+        m_items[tail & (Capacity - 1)] = v;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T &v) {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) return false;
+        v = m_items[head & (Capacity - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Блокирующие варианты
+    void push(const T &v) {
+        if (!tryPush(v)) wait([&]{ return tryPush(v); });
+        wake();
+    }
+    T pop() {
+        T v;
+        if (!tryPop(v)) wait([&]{ return tryPop(v); });
+        wake();
+        return v;
+    }
+
+private:
+    static constexpr int SPIN_TRIES = 64;
+
+    template<class Try>
+    void wait(const Try &tryOnce) {
+        for (int i = 0; i < SPIN_TRIES; ++i) {
+            std::this_thread::yield();
+            if (tryOnce()) return;
+        }
+        std::unique_lock<std::mutex> lk(m_mutex);
+        m_sleepers.fetch_add(1, std::memory_order_acq_rel);
+        m_cv.wait(lk, tryOnce);
+        m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Разбудить другую сторону, если она спит. Обе стороны делают RMW над
+    // m_sleepers, поэтому засыпающий либо увидит изменение очереди, либо
+    // будет учтён здесь и разбужен
+    void wake() {
+        if (m_sleepers.fetch_add(0, std::memory_order_acq_rel) > 0) {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            m_cv.notify_all();
+        }
+    }
+
+    std::array<T, Capacity> m_items{};
+    alignas(64) std::atomic<std::size_t> m_head{0};
+    alignas(64) std::atomic<std::size_t> m_tail{0};
+    alignas(64) std::atomic<int> m_sleepers{0};
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+};
@@ -0,0 +1,83 @@
+#include "threadpool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threads)
+{
+    if (threads <= 0) threads = int(std::max(1u, std::thread::hardware_concurrency()));
+    // вызывающий поток тоже работает, поэтому рабочих на один меньше
+    for (int i = 1; i < threads; ++i)
+        m_workers.emplace_back([this]{ workerLoop(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto &t : m_workers) t.join();
+}
+
+ThreadPool& ThreadPool::instance()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+std::size_t ThreadPool::work(Job &job)
+{
+    std::size_t count = 0;
+    for (;;) {
+        const std::size_t c = job.next.fetch_add(1, std::memory_order_relaxed);
+        if (c >= job.chunks) break;
+        const std::size_t b = c * job.grain;
+        const std::size_t e = std::min(job.n, b + job.grain);
+        job.call(job.ctx, b, e);
+        ++count;
+    }
+    return count;
+}
+
+void ThreadPool::run(Job &job)
+{
+    if (job.chunks > 1 && !m_workers.empty()) {
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            m_jobs.push_back(&job);
+        }
+        m_wake.notify_all();
+    }
+
+    const std::size_t mine = work(job);
+
+    std::unique_lock<std::mutex> lk(m_mutex);
+    job.done += mine;
+    auto it = std::find(m_jobs.begin(), m_jobs.end(), &job);
+    if (it != m_jobs.end()) m_jobs.erase(it);
+    m_finished.wait(lk, [&]{ return job.done == job.chunks && job.users == 0; });
+}
+
+void ThreadPool::workerLoop()
+{
+    std::unique_lock<std::mutex> lk(m_mutex);
+    for (;;) {
+        m_wake.wait(lk, [&]{ return m_stop || !m_jobs.empty(); });
+        if (m_stop) return;
+
+        Job *job = m_jobs.front();
+        if (job->next.load(std::memory_order_relaxed) >= job->chunks) {
+            // блоки розданы — убираем из очереди, завершение ждёт вызывающий
+            m_jobs.pop_front();
+            continue;
+        }
+        ++job->users;
+        lk.unlock();
+        const std::size_t count = work(*job);
+        lk.lock();
+        job->done += count;
+        --job->users;
+        if (job->done == job->chunks && job->users == 0) m_finished.notify_all();
+    }
+}
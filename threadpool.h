@@ -0,0 +1,63 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Общий пул потоков для пакетной обработки.
+//
+// parallelFor делит диапазон [0, n) на блоки и раздаёт их рабочим потокам;
+// вызывающий поток тоже берёт блоки, поэтому вложенные вызовы и вызовы из
+// нескольких потоков сразу не блокируют друг друга. Функтор не копируется.
+class ThreadPool {
+public:
+    explicit ThreadPool(int threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Пул на все ядра, создаётся при первом обращении
+    static ThreadPool& instance();
+
+    // Число потоков, выполняющих блоки (рабочие + вызывающий)
+    int concurrency() const { return int(m_workers.size()) + 1; }
+
+    // fn(begin, end) для блоков размера grain; возвращает после завершения всех блоков
+    template<class Fn>
+    void parallelFor(std::size_t n, std::size_t grain, Fn&& fn) {
+        if (n == 0) return;
+        if (grain == 0) grain = 1;
+        using F = std::remove_reference_t<Fn>;
+        auto call = [](void *ctx, std::size_t b, std::size_t e) { (*static_cast<F*>(ctx))(b, e); };
+        Job job{ call, const_cast<void*>(static_cast<const void*>(&fn)), n, grain, (n + grain - 1) / grain };
+        run(job);
+    }
+
+private:
+    struct Job {
+        void (*call)(void*, std::size_t, std::size_t);
+        void *ctx;
+        std::size_t n;
+        std::size_t grain;
+        std::size_t chunks;
+        std::atomic<std::size_t> next{0};
+        std::size_t done = 0;   // под m_mutex
+        int users = 0;          // рабочие, держащие ссылку на job (под m_mutex)
+    };
+
+    void run(Job &job);
+    std::size_t work(Job &job);   // выполнить доступные блоки, вернуть их число
+    void workerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_finished;
+    std::deque<Job*> m_jobs;
+    bool m_stop = false;
+};
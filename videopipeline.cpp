@@ -0,0 +1,372 @@
+#include "videopipeline.h"
+#include "ColorModels.h"
+#include "fastlab.h"
+#include "spscqueue.h"
+#include "threadpool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace VideoPipeline {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int POOL_FRAMES = 4;
+
+enum class Layout { RGB24, YUV420, YUV444, Mono };
+
+struct Frame {
+    std::vector<std::uint8_t> in;
+    std::vector<float> out;       // 3 float на пиксель
+    Clock::time_point start;
+    double readMs = 0.0;
+    double convertMs = 0.0;
+};
+
+// Целочисленные коэффициенты YUV -> RGB (x256) для выбранной матрицы и диапазона
+struct YuvCoeffs {
+    int yOffset, yScale, rv, gu, gv, bu;
+};
+
+YuvCoeffs makeYuvCoeffs(Matrix matrix, bool fullRange) {
+    const double kr = matrix == Matrix::BT709 ? 0.2126 : 0.299;
+    const double kb = matrix == Matrix::BT709 ? 0.0722 : 0.114;
+    const double kg = 1.0 - kr - kb;
+    const double ys = fullRange ? 1.0 : 255.0 / 219.0;
+    const double cs = fullRange ? 1.0 : 255.0 / 224.0;
+    auto fx = [](double v) { return int(std::lround(v * 256.0)); };
+    return { fullRange ? 0 : 16, fx(ys),
+             fx(cs * 2.0 * (1.0 - kr)),
+             fx(cs * 2.0 * (1.0 - kb) * kb / kg),
+             fx(cs * 2.0 * (1.0 - kr) * kr / kg),
+             fx(cs * 2.0 * (1.0 - kb)) };
+}
+
+struct Stream {
+    Layout layout = Layout::RGB24;
+    int width = 0;
+    int height = 0;
+    bool y4m = false;
+    bool fullRange = false;      // Y4M XCOLORRANGE=FULL
+    YuvCoeffs yuv{};
+
+    std::size_t frameBytes() const {
+        const std::size_t px = std::size_t(width) * height;
+        const std::size_t cpx = std::size_t((width + 1) / 2) * ((height + 1) / 2);
+        switch (layout) {
+        case Layout::RGB24:  return px * 3;
+        case Layout::YUV420: return px + 2 * cpx;
+        case Layout::YUV444: return px * 3;
+        case Layout::Mono:   return px;
+        }
+        return 0;
+    }
+};
+
+double msSince(Clock::time_point t) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t).count();
+}
+
+// Строка заголовка до '\n' (без него); false — конец потока
+bool readLine(std::FILE *in, std::string &line) {
+    line.clear();
+    int c;
+    while ((c = std::fgetc(in)) != EOF && c != '\n') line.push_back(char(c));
+    return c != EOF || !line.empty();
+}
+
+bool parseY4MHeader(const std::string &line, Stream &s) {
+    if (line.compare(0, 9, "YUV4MPEG2") != 0) return false;
+    s.y4m = true;
+    s.layout = Layout::YUV420;
+    std::size_t pos = 9;
+    while (pos < line.size()) {
+        while (pos < line.size() && line[pos] == ' ') ++pos;
+        std::size_t end = line.find(' ', pos);
+        if (end == std::string::npos) end = line.size();
+        const std::string tok = line.substr(pos, end - pos);
+        pos = end;
+        if (tok.empty()) continue;
+        if (tok[0] == 'W') s.width = std::atoi(tok.c_str() + 1);
+        else if (tok[0] == 'H') s.height = std::atoi(tok.c_str() + 1);
+        else if (tok[0] == 'C') {
+            const std::string cs = tok.substr(1);
+            if (cs.compare(0, 3, "420") == 0 && cs.find("p1") == std::string::npos) s.layout = Layout::YUV420;
+            else if (cs == "444") s.layout = Layout::YUV444;
+            else if (cs == "mono") s.layout = Layout::Mono;
+            else {
+                std::fprintf(stderr, "video: unsupported Y4M colorspace C%s\n", cs.c_str());
+                return false;
+            }
+        }
+        else if (tok == "XCOLORRANGE=FULL") s.fullRange = true;
+        else if (tok == "XCOLORRANGE=LIMITED") s.fullRange = false;
+    }
+    return s.width > 0 && s.height > 0;
+}
+
+inline std::uint8_t clampByte(int v) { return std::uint8_t(v < 0 ? 0 : (v > 255 ? 255 : v)); }
+
+inline Color::RGB yuvToRGB(const YuvCoeffs &k, int Y, int U, int V) {
+    const int c = k.yScale * (Y - k.yOffset), d = U - 128, e = V - 128;
+    return { clampByte((c + k.rv * e + 128) >> 8),
+             clampByte((c - k.gu * d - k.gv * e + 128) >> 8),
+             clampByte((c + k.bu * d + 128) >> 8) };
+}
+
+inline void toLab(const Color::RGB &rgb, float *d) {
+    FastLab::rgbToLab(FastLab::tables(), rgb.r, rgb.g, rgb.b, d);
+}
+
+inline void toHSV(const Color::RGB &rgb, float *d) {
+    FastLab::rgbToHSV(rgb.r, rgb.g, rgb.b, d);
+}
+
+template<class Convert>
+void convertRows(const Stream &s, const Frame &f, float *out, int y0, int y1, Convert conv) {
+    const int w = s.width;
+    const std::size_t ysize = std::size_t(w) * s.height;
+    const int cw = (w + 1) / 2;
+    const std::size_t csize = std::size_t(cw) * ((s.height + 1) / 2);
+    const std::uint8_t *in = f.in.data();
+
+    for (int y = y0; y < y1; ++y) {
+        float *d = out + std::size_t(y) * w * 3;
+        switch (s.layout) {
+        case Layout::RGB24: {
+            const std::uint8_t *p = in + std::size_t(y) * w * 3;
+            for (int x = 0; x < w; ++x, p += 3, d += 3) conv(Color::RGB{ p[0], p[1], p[2] }, d);
+            break;
+        }
+        case Layout::YUV420: {
+            const std::uint8_t *Y = in + std::size_t(y) * w;
+            const std::uint8_t *U = in + ysize + std::size_t(y / 2) * cw;
+            const std::uint8_t *V = U + csize;
+            for (int x = 0; x < w; ++x, d += 3) conv(yuvToRGB(s.yuv, Y[x], U[x / 2], V[x / 2]), d);
+            break;
+        }
+        case Layout::YUV444: {
+            const std::uint8_t *Y = in + std::size_t(y) * w;
+            const std::uint8_t *U = Y + ysize;
+            const std::uint8_t *V = U + ysize;
+            for (int x = 0; x < w; ++x, d += 3) conv(yuvToRGB(s.yuv, Y[x], U[x], V[x]), d);
+            break;
+        }
+        case Layout::Mono: {
+            const std::uint8_t *Y = in + std::size_t(y) * w;
+            for (int x = 0; x < w; ++x, d += 3) conv(yuvToRGB(s.yuv, Y[x], 128, 128), d);
+            break;
+        }
+        }
+    }
+}
+
+void convertFrame(const Stream &s, Frame &f, Target target) {
+    float *out = f.out.data();
+    const std::size_t grain = std::max(1, 16384 / std::max(1, s.width));
+    ThreadPool::instance().parallelFor(std::size_t(s.height), grain, [&](std::size_t y0, std::size_t y1) {
+        if (target == Target::Lab) convertRows(s, f, out, int(y0), int(y1), toLab);
+        else                       convertRows(s, f, out, int(y0), int(y1), toHSV);
+    });
+}
+
+} // namespace
+
+bool run(std::FILE *in, std::FILE *out, const Options &opt, Report &report)
+{
+    Stream s;
+    s.width = opt.width;
+    s.height = opt.height;
+
+    // Y4M определяется по полной сигнатуре "YUV4MPEG2 "; иначе поток считается
+    // raw RGB24, а прочитанные при проверке байты — началом первого кадра
+    static const char Y4M_SIGNATURE[] = "YUV4MPEG2 ";
+    const std::size_t sigLen = sizeof(Y4M_SIGNATURE) - 1;
+    std::string prefix;
+    while (prefix.size() < sigLen) {
+        const int c = std::fgetc(in);
+        if (c == EOF) break;
+        prefix.push_back(char(c));
+        if (char(c) != Y4M_SIGNATURE[prefix.size() - 1]) break;
+    }
+    std::string line;
+    if (prefix == Y4M_SIGNATURE) {
+        prefix.clear();
+        if (!readLine(in, line) || !parseY4MHeader(Y4M_SIGNATURE + line, s)) {
+            std::fprintf(stderr, "video: bad Y4M header\n");
+            return false;
+        }
+    }
+    if (s.width <= 0 || s.height <= 0) {
+        std::fprintf(stderr, "video: frame size unknown, use --size WxH for raw RGB24\n");
+        return false;
+    }
+    // HD-источники (ffmpeg и др.) обычно в BT.709, SD — в BT.601
+    Matrix matrix = opt.matrix;
+    if (matrix == Matrix::Auto) matrix = s.height >= 720 ? Matrix::BT709 : Matrix::BT601;
+    s.yuv = makeYuvCoeffs(matrix, s.fullRange);
+
+    const std::size_t pixels = std::size_t(s.width) * s.height;
+    std::vector<Frame> pool(POOL_FRAMES);
+    SpscQueue<Frame*, 8> freeQ, convertQ, writeQ;
+    for (Frame &f : pool) {
+        f.in.resize(s.frameBytes());
+        f.out.resize(pixels * 3);
+        freeQ.push(&f);
+    }
+
+    FastLab::tables();   // построить таблицы до старта конвейера
+    std::atomic<bool> failed{false};
+    const auto t0 = Clock::now();
+
+    // Байты входа: сначала остаток prefix, затем поток
+    std::size_t prefixPos = 0;
+    auto readBytes = [&](std::uint8_t *dst, std::size_t n) {
+        const std::size_t got = std::min(n, prefix.size() - prefixPos);
+        std::memcpy(dst, prefix.data() + prefixPos, got);
+        prefixPos += got;
+        return got + std::fread(dst + got, 1, n - got, in);
+    };
+
+    // Стадия 1: чтение кадров в буферы пула. freeQ читает только эта стадия
+    // (пишет — запись), поэтому недочитанный кадр просто остаётся в pool
+    std::thread reader([&]{
+        std::string frameLine;
+        while (!failed.load(std::memory_order_relaxed)) {
+            Frame *f = freeQ.pop();
+            f->start = Clock::now();
+            if (s.y4m) {
+                if (!readLine(in, frameLine) || frameLine.compare(0, 5, "FRAME") != 0) break;
+            }
+            if (readBytes(f->in.data(), f->in.size()) != f->in.size()) break;
+            f->readMs = msSince(f->start);
+            convertQ.push(f);
+        }
+        convertQ.push(nullptr);
+    });
+
+    // Стадия 2: конвертация, кадр делится на полосы в пуле потоков
+    std::thread converter([&]{
+        for (;;) {
+            Frame *f = convertQ.pop();
+            if (!f) break;
+            const auto tc = Clock::now();
+            convertFrame(s, *f, opt.target);
+            f->convertMs = msSince(tc);
+            writeQ.push(f);
+        }
+        writeQ.push(nullptr);
+    });
+
+    // Стадия 3 (текущий поток): запись / анализ
+    double readSum = 0, convSum = 0, writeSum = 0, latSum = 0, latMax = 0;
+    long long frames = 0;
+    for (;;) {
+        Frame *f = writeQ.pop();
+        if (!f) break;
+        const auto tw = Clock::now();
+        if (!failed.load(std::memory_order_relaxed)) {
+            if (opt.output == Output::Raw) {
+                if (std::fwrite(f->out.data(), sizeof(float), f->out.size(), out) != f->out.size())
+                    failed = true;
+            } else if (opt.output == Output::Stats) {
+                double sum[3] = { 0, 0, 0 };
+                const float *p = f->out.data();
+                for (std::size_t i = 0; i < pixels; ++i, p += 3) {
+                    sum[0] += p[0]; sum[1] += p[1]; sum[2] += p[2];
+                }
+                if (std::fprintf(out, "%lld %.4f %.4f %.4f\n", frames,
+                                 sum[0] / pixels, sum[1] / pixels, sum[2] / pixels) < 0)
+                    failed = true;
+            }
+        }
+        const double wms = msSince(tw);
+        const double lat = msSince(f->start);
+        readSum += f->readMs; convSum += f->convertMs; writeSum += wms;
+        latSum += lat; latMax = std::max(latMax, lat);
+        ++frames;
+        freeQ.push(f);
+    }
+
+    reader.join();
+    converter.join();
+    std::fflush(out);
+
+    report.frames = frames;
+    report.seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    if (frames > 0) {
+        report.readMs = readSum / frames;
+        report.convertMs = convSum / frames;
+        report.writeMs = writeSum / frames;
+        report.latencyMs = latSum / frames;
+        report.maxLatencyMs = latMax;
+    }
+    if (failed) std::fprintf(stderr, "video: write failed\n");
+    return !failed;
+}
+
+int runFromArgs(int argc, char *argv[])
+{
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (a == "--video") continue;
+        if (a == "--size" && hasValue) {
+            if (std::sscanf(argv[++i], "%dx%d", &opt.width, &opt.height) != 2) {
+                std::fprintf(stderr, "video: bad --size, expected WxH\n");
+                return 2;
+            }
+        } else if (a == "--to" && hasValue) {
+            const std::string v = argv[++i];
+            if (v == "lab") opt.target = Target::Lab;
+            else if (v == "hsv") opt.target = Target::HSV;
+            else { std::fprintf(stderr, "video: unknown --to %s\n", v.c_str()); return 2; }
+        } else if (a == "--matrix" && hasValue) {
+            const std::string v = argv[++i];
+            if (v == "601") opt.matrix = Matrix::BT601;
+            else if (v == "709") opt.matrix = Matrix::BT709;
+            else { std::fprintf(stderr, "video: unknown --matrix %s\n", v.c_str()); return 2; }
+        } else if (a == "--out" && hasValue) {
+            const std::string v = argv[++i];
+            if (v == "stats") opt.output = Output::Stats;
+            else if (v == "raw") opt.output = Output::Raw;
+            else if (v == "null") opt.output = Output::Null;
+            else { std::fprintf(stderr, "video: unknown --out %s\n", v.c_str()); return 2; }
+        } else {
+            std::fprintf(stderr, "video: unknown argument %s\n", a.c_str());
+            return 2;
+        }
+    }
+
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+    Report r;
+    const bool ok = run(stdin, stdout, opt, r);
+    std::fprintf(stderr,
+                 "video: %lld frames in %.3f s, %.1f fps\n"
+                 "video: per frame read %.2f ms, convert %.2f ms, write %.2f ms; "
+                 "latency avg %.2f ms, max %.2f ms\n",
+                 r.frames, r.seconds, r.fps(), r.readMs, r.convertMs, r.writeMs,
+                 r.latencyMs, r.maxLatencyMs);
+    return ok ? 0 : 1;
+}
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdio>
+
+// Потоковая обработка видео: кадры Y4M или raw RGB24 со stdin переводятся
+// в LAB или HSV и записываются / анализируются.
+//
+// Стадии чтение -> конвертация -> запись работают в отдельных потоках и
+// связаны lock-free очередями (SpscQueue). Кадры берутся из заранее
+// выделенного пула и возвращаются в него после записи, поэтому на кадр
+// память не выделяется. Конвертация кадра делится на полосы в ThreadPool.
+//
+// Запуск:  ColorConverter --video [--size WxH] [--to lab|hsv] [--matrix 601|709]
+//                               [--out stats|raw|null]
+//   --size   размер кадра для raw RGB24 (для Y4M берётся из заголовка)
+//   --to     целевая модель, по умолчанию lab
+//   --matrix матрица YUV для Y4M; по умолчанию 709 при высоте от 720, иначе 601.
+//            Диапазон берётся из XCOLORRANGE заголовка (по умолчанию LIMITED)
+//   --out    stats — средние значения кадра строкой в stdout (по умолчанию),
+//            raw   — float32 по 3 канала на пиксель в stdout,
+//            null  — только замер производительности
+// Итог (задержки стадий и fps) печатается в stderr.
+namespace VideoPipeline {
+
+enum class Target { Lab, HSV };
+enum class Output { Stats, Raw, Null };
+enum class Matrix { Auto, BT601, BT709 };
+
+struct Options {
+    int width = 0;         // обязательно для raw RGB24
+    int height = 0;
+    Target target = Target::Lab;
+    Matrix matrix = Matrix::Auto;
+    Output output = Output::Stats;
+};
+
+struct Report {
+    long long frames = 0;
+    double seconds = 0.0;
+    double readMs = 0.0;      // среднее время стадии на кадр
+    double convertMs = 0.0;
+    double writeMs = 0.0;
+    double latencyMs = 0.0;   // среднее от начала чтения до конца записи
+    double maxLatencyMs = 0.0;
+
+    double fps() const { return seconds > 0.0 ? frames / seconds : 0.0; }
+};
+
+// Обработать поток in; false — ошибка формата (сообщение в stderr)
+bool run(std::FILE *in, std::FILE *out, const Options &opt, Report &report);
+
+// Разобрать аргументы командной строки, выполнить и напечатать отчёт;
+// возвращает код завершения процесса
+int runFromArgs(int argc, char *argv[]);
+
+}